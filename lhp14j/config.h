@@ -5,9 +5,31 @@
 
 #define JOYSTICK_BUTTON_COUNT 1
 #define JOYSTICK_AXIS_COUNT 2
+// Interval (ms) of the keyboard, mouse and joystick endpoints: 1 ms is the fastest for full speed USB
+#define USB_POLLING_INTERVAL_MS 1
+
+// Stick for lib_ion/joystick.h. Not measured: the whole ADC range (same as the former analogReadPin() / 4 - 128)
+// If you use LHP14F or previous version, JS_PIN_Y is D4
+#define JS_PIN_X F4
+#define JS_PIN_Y F5
+// Default calibration: a keymap can use its own by setting all six in its config.h (#undef, then #define)
+#ifndef JS_X_LOW
+#define JS_X_LOW 0
+#define JS_X_MID JS_ADC_CENTER
+#define JS_X_HIGH JS_ADC_MAX
+#define JS_Y_LOW 0
+#define JS_Y_MID JS_ADC_CENTER
+#define JS_Y_HIGH JS_ADC_MAX
+#endif
 
 #define OLED_TIMEOUT 0
 
+#ifdef OLED_FONT_SUBSET
+// Generated by rules.mk
+#include "font_subset.h"
+#define OLED_FONT_H "keyboards/lhp14j/glcdfont_lhp14_subset.c"
+#else
 #define OLED_FONT_H "keyboards/lhp14j/glcdfont_lhp14.c"
+#endif
 
 #define LAYER_STATE_32BIT
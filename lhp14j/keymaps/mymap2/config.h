@@ -19,3 +19,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #pragma once
+
+// Time the keycode lookup of the sparse layers against keymaps[] and show it on the OLED at startup
+// (lib_ion/keymap_sparse.h)
+// #define SPARSE_KEYMAP_BENCHMARK 1000
+
+// Time process_macro_keycode() and show it on the OLED at startup, on the same line as
+// SPARSE_KEYMAP_BENCHMARK (enable one of them at a time) (lib_ion/macro.h)
+// #define MACRO_BENCHMARK 1000
@@ -1,6 +1,12 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
+#include "lib_ion/joystick.h"
+#include "lib_ion/macro.h"
+#include "lib_ion/scheduler.h"
+#include "lib_ion/keymap_sparse.h"
+#include "lib_ion/layer.h"
+#include "lib_ion/selector.h"
 
 
 // Layer(=job) MAX 32jobs available
@@ -41,30 +47,103 @@
 
 
 void render_logo(void) {
+    // OLED_LOGO_BITMAP では起動時にビットマップで描いたロゴがそのまま残る
+    #ifndef OLED_LOGO_BITMAP
     oled_set_cursor(0, 0);
     oled_write_P(lhp_logo, false);
+    #endif
 }
 
+static struct LAYER_CACHE layer_cache = LAYER_CACHE_INIT;
+static uint8_t rendered_layer_seq = 0;
+
+#ifdef SPARSE_KEYMAP_BENCHMARK
+// Defined after the sparse layers below
+void render_sparse_benchmark(void);
+#endif
+
+// Job names shown on the OLED and in the job selector (hold JS_0 and tilt the stick)
+static const char PROGMEM job_names[][LAYER_NAME_SIZE] = {
+    [DRK] = "DARK KNIGHT",
+    [GNB] = "GUNBREAKER",
+    [WAR] = "WARRIOR",
+    [PLD] = "PALADIN",
+    [DRG] = "DRAGOON",
+    [SAM] = "SAMURAI",
+    [MNK] = "MONK",
+    [RPR] = "REAPER",
+    [NIN] = "NINJA",
+    [BRD] = "BARD",
+    [MCH] = "MACHINIST",
+    [DNC] = "DANCER",
+    [RDM] = "RED MAGE",
+    [SMN] = "SUMMONER",
+    [BLM] = "BLACK MAGE",
+    [BLU] = "BLUE MAGE",
+    [WHM] = "WHITE MAGE",
+    [SCH] = "SCHOLAR",
+    [AST] = "ASTROLOGIAN",
+    [SGE] = "SAGE",
+    [GAT] = "GATHERER",
+    [CRA] = "CRAFTER",
+    [GLA] = "GLADIATOR",
+    [MRD] = "MARAUDER",
+    [LNC] = "LANCER",
+    [PUG] = "PUGILIST",
+    [ROG] = "ROGUE",
+    [ARC] = "ARCHER",
+    [THM] = "THAUMATURGE",
+    [ACN] = "ARCANIST",
+    [CNJ] = "CONJURER",
+    [RGB] = "RGB LED TEST",
+};
+static struct LAYER_SELECTOR_STATE job_selector = LAYER_SELECTOR_INIT(ARRAY_SIZE(job_names));
+
+// Macros: played from housekeeping_task_user() without blocking the matrix scan
+static struct MACRO_STATE macro_state = MACRO_INIT;
+static const uint8_t PROGMEM macro_sr_cs[] = {
+    MC_WRAP(MOD_LALT), MC_TAP(KC_0), MC_UNWRAP, MC_TAP(KC_MINS), MC_END
+};
+static const uint8_t PROGMEM macro_rr_rd[] = {
+    MC_TAP(LCA(KC_2)), MC_TAP(KC_5), MC_END
+};
+
 enum custom_keycodes {
+  // Macros: macros[keycode - MACRO_FIRST]
   SR_CS = SAFE_RANGE,
   RR_RD,
   RGBRST
 };
+#define MACRO_FIRST SR_CS
+
+static const uint8_t *const PROGMEM macros[] = {
+  [SR_CS - MACRO_FIRST] = macro_sr_cs,
+  [RR_RD - MACRO_FIRST] = macro_rr_rd,
+};
+
+#ifdef MACRO_BENCHMARK
+void render_macro_benchmark(void) {
+    // process_macro_keycode() 1回の時間 (ns): マクロのキーを離したとき / それ以外のキーを押したとき
+    // 計測は最初のフレームで一度だけ。SPARSE_KEYMAP_BENCHMARK と同じく、レイヤーを変えるまで表示する
+    static bool is_measured = false;
+    if (is_measured) return;
+    struct MACRO_DISPATCH_BENCHMARK benchmark;
+    run_macro_benchmark(&benchmark, &macro_state, MACRO_FIRST, macros, ARRAY_SIZE(macros));
+    is_measured = true;
+    oled_set_cursor(0, 3);
+    oled_write_P(PSTR("MC"), false);
+    oled_write(get_u16_str(benchmark.hit_ns, ' '), false);
+    oled_write_P(PSTR("/"), false);
+    oled_write(get_u16_str(benchmark.miss_ns, ' '), false);
+    oled_write_P(PSTR("ns"), false);
+}
+#endif
 
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+  if (!process_macro_keycode(&macro_state, keycode, record->event.pressed, MACRO_FIRST, macros, ARRAY_SIZE(macros))) return false;
   switch (keycode) {
-    case SR_CS:
-      if (record->event.pressed) {
-        SEND_STRING(SS_LALT("0") "-");
-      }
-      break;
-    case RR_RD:
-      if (record->event.pressed) {
-        register_code(KC_LCTL);
-        SEND_STRING(SS_LALT("2"));
-        unregister_code(KC_LCTL);
-        SEND_STRING("5");
-      }
+    case JS_0:
+      press_layer_selector(&job_selector, record->event.pressed, layer_cache.layer);
       break;
     case RGBRST:
       #ifdef RGBLIGHT_ENABLE
@@ -79,177 +158,164 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 }
 
 
+layer_state_t layer_state_set_user(layer_state_t state) {
+    return update_layer_cache(&layer_cache, state);
+}
+
 void render_layer(void) {	
+    // Only when the layer is changed: the name and the color stay until the next change
+    if (!is_layer_changed(&layer_cache, &rendered_layer_seq)) return;
     oled_set_cursor(0, 3);
     // Host Keyboard Layer Status
     oled_write_P(PSTR("Layer: "), false);
+    if (layer_cache.layer < ARRAY_SIZE(job_names)) {
+        oled_write_ln_P(job_names[layer_cache.layer], false);
+    } else {
+        oled_write_ln_P(PSTR("Undefined"), false);
+    }
 
-    switch (get_highest_layer(layer_state)) {
-
+    switch (layer_cache.layer) {
         case DRK:
-            oled_write_P(PSTR("DARK KNIGHT\n"), false);
             rgblight_sethsv(0, 255, 90);
             break;
-            
+
         case GNB:
-            oled_write_P(PSTR("GUNBREAKER\n"), false);
             rgblight_sethsv(0, 0, 100);
             break;
-            
+
         case WAR:
-            oled_write_P(PSTR("WARRIOR\n"), false);
             rgblight_sethsv(85, 255, 90);
             break;
-            
+
         case PLD:
-            oled_write_P(PSTR("PALADIN\n"), false);
             rgblight_sethsv(127, 170, 100);
             break;
-            
+
         case DRG:
-            oled_write_P(PSTR("DRAGOON\n"), false);
             rgblight_sethsv(170, 255, 180);
             break;
-            
+
         case SAM:
-            oled_write_P(PSTR("SAMURAI\n"), false);
             rgblight_sethsv(0, 255, 180);
             break;
-            
+
         case MNK:
-            oled_write_P(PSTR("MONK\n"), false);
             rgblight_sethsv(85, 255, 50);
             break;
-            
+
         case RPR:
-            oled_write_P(PSTR("REAPER\n"), false);
             rgblight_sethsv(0, 255, 20);
             break;
-            
+
         case NIN:
-            oled_write_P(PSTR("NINJA\n"), false);
             rgblight_sethsv(191, 255, 150);
             break;
-            
+
         case BRD:
-            oled_write_P(PSTR("BARD\n"), false);
             rgblight_sethsv(91, 199, 140);
             break;
-            
+
         case MCH:
-            oled_write_P(PSTR("MACHINIST\n"), false);
             rgblight_sethsv(68, 15, 150);
             break;
-            
+
         case DNC:
-            oled_write_P(PSTR("DANCER\n"), false);
             rgblight_sethsv(213, 255, 180);
             break;
-            
+
         case RDM:
-            oled_write_P(PSTR("RED MAGE\n"), false);
             rgblight_sethsv(0, 255, 220);
             break;
-            
+
         case SMN:
-            oled_write_P(PSTR("SUMMONER\n"), false);
             rgblight_sethsv(20, 255, 100);
             break;
-            
+
         case BLM:
-            oled_write_P(PSTR("BLACK MAGE\n"), false);
             rgblight_sethsv(68, 15, 50);
             break;
-            
+
         case BLU:
-            oled_write_P(PSTR("BLUE MAGE\n"), false);
             rgblight_sethsv(170, 255, 200);
             break;
-            
+
         case WHM:
-            oled_write_P(PSTR("WHITE MAGE\n"), false);
             rgblight_sethsv(11, 176, 180);
             break;
-            
+
         case SCH:
-            oled_write_P(PSTR("SCHOLAR\n"), false);
             rgblight_sethsv(20, 255, 210);
             break;
-            
+
         case AST:
-            oled_write_P(PSTR("ASTROLOGIAN\n"), false);
             rgblight_sethsv(127, 255, 180);
             break;
 
         case SGE:
-            oled_write_P(PSTR("SAGE\n"), false);
             rgblight_sethsv(100, 100, 90);
             break;
-            
+
         case GAT:
-            oled_write_P(PSTR("GATHERER\n"), false);
             rgblight_sethsv(68, 130, 190);
             break;
-            
+
         case CRA:
-            oled_write_P(PSTR("CRAFTER\n"), false);
             rgblight_sethsv(198, 130, 190);
             break;
-            
+
         case GLA:
-            oled_write_P(PSTR("GLADIATOR\n"), false);
             rgblight_sethsv(127, 170, 80);
             break;
-            
+
         case MRD:
-            oled_write_P(PSTR("MARAUDER\n"), false);
             rgblight_sethsv(85, 255, 70);
             break;
+
         case LNC:
-            oled_write_P(PSTR("LANCER\n"), false);
             rgblight_sethsv(170, 255, 160);
             break;
-            
+
         case PUG:
-            oled_write_P(PSTR("PUGILIST\n"), false);
             rgblight_sethsv(85, 255, 30);
             break;
+
         case ROG:
-            oled_write_P(PSTR("ROGUE\n"), false);
             rgblight_sethsv(190, 255, 130);
             break;
-            
+
         case ARC:
-            oled_write_P(PSTR("ARCHER\n"), false);
             rgblight_sethsv(90, 200, 120);
             break;
+
         case THM:
-            oled_write_P(PSTR("THAUMATURGE\n"), false);
             rgblight_sethsv(68, 15, 30);
             break;
-            
+
         case ACN:
-            oled_write_P(PSTR("ARCANIST\n"), false);
             rgblight_sethsv(20, 255, 80);
             break;
+
         case CNJ:
-            oled_write_P(PSTR("CONJURER\n"), false);
             rgblight_sethsv(10, 176, 160);
             break;
-            
-        case RGB:
-            oled_write_P(PSTR("RGB LED TEST\n"), false);
-            break;
-            
-        default:
-            // Or use the write_ln shortcut over adding '\n' to the end of your string
-            oled_write_ln_P(PSTR("Undefined"), false);
     }
 }
 
 bool oled_task_user(void) {
+    if (job_selector.active) {
+        render_layer_selector(&job_selector, job_names);
+        // Draw the layer again after the selector is closed
+        rendered_layer_seq = 0;
+        return false;
+    }
     render_logo();
     render_layer();
+    #ifdef SPARSE_KEYMAP_BENCHMARK
+    render_sparse_benchmark();
+    #endif
+    #ifdef MACRO_BENCHMARK
+    render_macro_benchmark();
+    #endif
     return false;
 }
 
@@ -293,7 +359,9 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
                                                            XXXXXXX,   JS_0,      \
                                                                       XXXXXXX    \
    ),
+};
 
+// Job layers after DRK: only the keys different from DRK (see lib_ion/keymap_sparse.h)
 
   /* GNB
    * ,------------------------------------------------.   
@@ -310,16 +378,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-
-   [GNB] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(WAR),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM gnb_keys[] = {SK(3, 8, TO(WAR))};
 
   /* WAR
    * ,------------------------------------------------.   
@@ -336,15 +395,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   [WAR] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(PLD),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM war_keys[] = {SK(3, 8, TO(PLD))};
 
   /* PLD
    * ,------------------------------------------------.   
@@ -361,16 +412,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [PLD] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(DRG),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM pld_keys[] = {SK(3, 8, TO(DRG))};
 
   /* DRG
    * ,------------------------------------------------.   
@@ -387,16 +429,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-
-   [DRG] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(SAM),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM drg_keys[] = {SK(3, 8, TO(SAM))};
 
   /* SAM
    * ,------------------------------------------------.   
@@ -413,16 +446,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-
-   [SAM] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(MNK),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM sam_keys[] = {SK(3, 8, TO(MNK))};
 
   /* MNK
    * ,------------------------------------------------.   
@@ -439,15 +463,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   [MNK] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(NIN),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM mnk_keys[] = {SK(3, 8, TO(NIN))};
 
   /* NIN
    * ,------------------------------------------------.   
@@ -464,16 +480,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [NIN] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(RPR),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM nin_keys[] = {SK(3, 8, TO(RPR))};
 
   /* RPR
    * ,------------------------------------------------.   
@@ -490,16 +497,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [RPR] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(BRD),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM rpr_keys[] = {SK(3, 8, TO(BRD))};
 
   /* BRD
    * ,------------------------------------------------.   
@@ -516,16 +514,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-  [BRD] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(MCH),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM brd_keys[] = {SK(3, 8, TO(MCH))};
 
   /* MCH
    * ,------------------------------------------------.   
@@ -542,16 +531,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-
-   [MCH] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(DNC),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM mch_keys[] = {SK(3, 8, TO(DNC))};
 
   /* DNC
    * ,------------------------------------------------.   
@@ -568,15 +548,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   [DNC] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(RDM),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM dnc_keys[] = {SK(3, 8, TO(RDM))};
 
   /* RDM
    * ,------------------------------------------------.   
@@ -593,16 +565,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [RDM] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(SMN),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM rdm_keys[] = {SK(3, 8, TO(SMN))};
 
   /* SMN
    * ,------------------------------------------------.   
@@ -619,16 +582,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-
-   [SMN] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(BLM),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM smn_keys[] = {SK(3, 8, TO(BLM))};
 
   /* BLM
    * ,------------------------------------------------.   
@@ -645,16 +599,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-
-   [BLM] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(BLU),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM blm_keys[] = {SK(3, 8, TO(BLU))};
 
   /* BLU
    * ,------------------------------------------------.   
@@ -671,16 +616,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-
-   [BLU] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(WHM),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM blu_keys[] = {SK(3, 8, TO(WHM))};
 
   /* WHM
    * ,------------------------------------------------.   
@@ -697,16 +633,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [WHM] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(SCH),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM whm_keys[] = {SK(3, 8, TO(SCH))};
 
   /* SCH
    * ,------------------------------------------------.   
@@ -723,16 +650,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-
-   [SCH] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(AST),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM sch_keys[] = {SK(3, 8, TO(AST))};
 
   /* AST
    * ,------------------------------------------------.   
@@ -749,16 +667,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [AST] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(SGE),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM ast_keys[] = {SK(3, 8, TO(SGE))};
 
   /* SGE
    * ,------------------------------------------------.   
@@ -775,16 +684,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [SGE] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(GAT),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM sge_keys[] = {SK(3, 8, TO(GAT))};
 
   /* GAT
    * ,------------------------------------------------.   
@@ -801,16 +701,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-
-   [GAT] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(CRA),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM gat_keys[] = {SK(3, 8, TO(CRA))};
 
   /* CRA
    * ,------------------------------------------------.   
@@ -827,16 +718,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [CRA] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(GLA),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM cra_keys[] = {SK(3, 8, TO(GLA))};
 
   /* GLA
    * ,------------------------------------------------.   
@@ -853,16 +735,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [GLA] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(MRD),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM gla_keys[] = {SK(3, 8, TO(MRD))};
 
   /* MRD
    * ,------------------------------------------------.   
@@ -879,16 +752,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [MRD] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(LNC),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM mrd_keys[] = {SK(3, 8, TO(LNC))};
 
   /* LNC
    * ,------------------------------------------------.   
@@ -905,16 +769,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [LNC] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(PUG),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM lnc_keys[] = {SK(3, 8, TO(PUG))};
 
   /* PUG
    * ,------------------------------------------------.   
@@ -931,16 +786,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [PUG] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(ROG),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM pug_keys[] = {SK(3, 8, TO(ROG))};
 
   /* ROG
    * ,------------------------------------------------.   
@@ -957,16 +803,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [ROG] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(ARC),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM rog_keys[] = {SK(3, 8, TO(ARC))};
 
   /* ARC
    * ,------------------------------------------------.   
@@ -983,16 +820,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [ARC] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(THM),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM arc_keys[] = {SK(3, 8, TO(THM))};
 
   /* THM
    * ,------------------------------------------------.   
@@ -1009,15 +837,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   [THM] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(ACN),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM thm_keys[] = {SK(3, 8, TO(ACN))};
 
   /* ACN
    * ,------------------------------------------------.   
@@ -1034,16 +854,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [ACN] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(CNJ),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM acn_keys[] = {SK(3, 8, TO(CNJ))};
 
   /* CNJ
    * ,------------------------------------------------.   
@@ -1060,16 +871,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
-   
-   [CNJ] = LAYOUT( \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,   XXXXXXX,              TO(RGB),   \
-                                                           XXXXXXX,   JS_0,      \
-                                                                      XXXXXXX    \
-   ),
-
+static const struct SPARSE_KEY PROGMEM cnj_keys[] = {SK(3, 8, TO(RGB))};
 
   /* RGB
    * ,------------------------------------------------.   
@@ -1086,35 +888,108 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    *                                           |      |   
    *                                           `------'   
    */
+static const struct SPARSE_KEY PROGMEM rgb_keys[] = {
+    SK(0, 0, UG_TOGG), SK(0, 1, UG_HUEU), SK(0, 2, UG_HUED), SK(0, 3, UG_SATU), SK(0, 4, UG_SATD),
+    SK(0, 5, UG_VALU), SK(0, 6, UG_VALD), SK(1, 0, UG_NEXT), SK(1, 1, RGBRST), SK(3, 8, TO(DRK))
+};
 
-  [RGB] = LAYOUT( \
-    UG_TOGG,    UG_HUEU,   UG_HUED,    UG_SATU,    UG_SATD,     UG_VALU,    UG_VALD,   \
-    UG_NEXT,    RGBRST,    XXXXXXX,    XXXXXXX,    XXXXXXX,     XXXXXXX,    XXXXXXX,   \
-    XXXXXXX,    XXXXXXX,   XXXXXXX,    XXXXXXX,    XXXXXXX,     XXXXXXX,    XXXXXXX,   \
-    XXXXXXX,    XXXXXXX,   XXXXXXX,    XXXXXXX,    XXXXXXX,                 TO(DRK),   \
-                                                                XXXXXXX,    JS_0,      \
-                                                                            XXXXXXX    \
-  ),
+#define SPARSE_FIRST GNB
+static const struct SPARSE_LAYER PROGMEM sparse_layers[] = {
+  [GNB - SPARSE_FIRST] = SPARSE_LAYER(DRK, gnb_keys),
+  [WAR - SPARSE_FIRST] = SPARSE_LAYER(DRK, war_keys),
+  [PLD - SPARSE_FIRST] = SPARSE_LAYER(DRK, pld_keys),
+  [DRG - SPARSE_FIRST] = SPARSE_LAYER(DRK, drg_keys),
+  [SAM - SPARSE_FIRST] = SPARSE_LAYER(DRK, sam_keys),
+  [MNK - SPARSE_FIRST] = SPARSE_LAYER(DRK, mnk_keys),
+  [NIN - SPARSE_FIRST] = SPARSE_LAYER(DRK, nin_keys),
+  [RPR - SPARSE_FIRST] = SPARSE_LAYER(DRK, rpr_keys),
+  [BRD - SPARSE_FIRST] = SPARSE_LAYER(DRK, brd_keys),
+  [MCH - SPARSE_FIRST] = SPARSE_LAYER(DRK, mch_keys),
+  [DNC - SPARSE_FIRST] = SPARSE_LAYER(DRK, dnc_keys),
+  [RDM - SPARSE_FIRST] = SPARSE_LAYER(DRK, rdm_keys),
+  [SMN - SPARSE_FIRST] = SPARSE_LAYER(DRK, smn_keys),
+  [BLM - SPARSE_FIRST] = SPARSE_LAYER(DRK, blm_keys),
+  [BLU - SPARSE_FIRST] = SPARSE_LAYER(DRK, blu_keys),
+  [WHM - SPARSE_FIRST] = SPARSE_LAYER(DRK, whm_keys),
+  [SCH - SPARSE_FIRST] = SPARSE_LAYER(DRK, sch_keys),
+  [AST - SPARSE_FIRST] = SPARSE_LAYER(DRK, ast_keys),
+  [SGE - SPARSE_FIRST] = SPARSE_LAYER(DRK, sge_keys),
+  [GAT - SPARSE_FIRST] = SPARSE_LAYER(DRK, gat_keys),
+  [CRA - SPARSE_FIRST] = SPARSE_LAYER(DRK, cra_keys),
+  [GLA - SPARSE_FIRST] = SPARSE_LAYER(DRK, gla_keys),
+  [MRD - SPARSE_FIRST] = SPARSE_LAYER(DRK, mrd_keys),
+  [LNC - SPARSE_FIRST] = SPARSE_LAYER(DRK, lnc_keys),
+  [PUG - SPARSE_FIRST] = SPARSE_LAYER(DRK, pug_keys),
+  [ROG - SPARSE_FIRST] = SPARSE_LAYER(DRK, rog_keys),
+  [ARC - SPARSE_FIRST] = SPARSE_LAYER(DRK, arc_keys),
+  [THM - SPARSE_FIRST] = SPARSE_LAYER(DRK, thm_keys),
+  [ACN - SPARSE_FIRST] = SPARSE_LAYER(DRK, acn_keys),
+  [CNJ - SPARSE_FIRST] = SPARSE_LAYER(DRK, cnj_keys),
+  [RGB - SPARSE_FIRST] = SPARSE_LAYER(DRK, rgb_keys),
+};
+static struct SPARSE_CACHE sparse_cache = SPARSE_CACHE_INIT;
 
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    return sparse_keycode(&sparse_cache, layer, key.row, key.col, SPARSE_FIRST, sparse_layers, ARRAY_SIZE(sparse_layers));
+}
+
+#ifdef SPARSE_KEYMAP_BENCHMARK
+void render_sparse_benchmark(void) {
+    // キーの検索1回の時間: 通常のレイヤー (ns) / 展開済みの差分レイヤー (ns) / レイヤーを変えた直後 (us)
+    // 計測は最初のフレームで一度だけ (0.1秒ほど止まる)。レイヤーを変えるまで表示する
+    static bool is_measured = false;
+    if (is_measured) return;
+    struct SPARSE_BENCHMARK benchmark;
+    run_sparse_benchmark(&benchmark, &sparse_cache, SPARSE_FIRST, sparse_layers, ARRAY_SIZE(sparse_layers));
+    is_measured = true;
+    oled_set_cursor(0, 3);
+    oled_write(get_u16_str(benchmark.dense_ns, ' '), false);
+    oled_write_P(PSTR("/"), false);
+    oled_write(get_u16_str(benchmark.hit_ns, ' '), false);
+    oled_write_P(PSTR("ns"), false);
+    oled_write(get_u16_str(benchmark.miss_us, ' '), false);
+    oled_write_P(PSTR("us"), false);
+}
+#endif
 
 
-};
 
 
 
 
 
+// Stick: pins and calibration in the config.h of the board (lib_ion/joystick.h)
+static struct JOYSTICK_STATE js_state = JS_INIT;
 
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
      JOYSTICK_AXIS_VIRTUAL, // x
      JOYSTICK_AXIS_VIRTUAL  // y
 };
 
-void matrix_scan_user(void) {
+static void run_keymap_macros(void) {
+    run_macros(&macro_state);
+}
+
+static void run_stick(void) {
+    read_joystick_angles(&js_state);
+    report_joystick(&js_state, 0, 1);
+    run_layer_selector(&job_selector, js_state.y);
+}
+
+// Tasks of housekeeping_task_user() (lib_ion/scheduler.h)
+// TASK(function, period (ms), budget (us), background)
+static struct TASK tasks[] = {
+    // The stick is read and reported once per USB poll instead of once per matrix scan
+    TASK(run_stick, USB_POLLING_INTERVAL_MS, TASK_BUDGET_UNMEASURED, false),
+    TASK(run_keymap_macros, 0, TASK_BUDGET_UNMEASURED, false),
+};
 
-    joystick_set_axis(0,analogReadPin(F4)/4 - 128);
-    joystick_set_axis(1,analogReadPin(F5)/4 - 128);  // if you use LHP14F or previous version, analogReadPin(D4)
+void keyboard_post_init_user(void) {
+    init_tasks(tasks, ARRAY_SIZE(tasks));
+}
 
+void housekeeping_task_user(void) {
+    run_tasks(tasks, ARRAY_SIZE(tasks));
 }
 
 
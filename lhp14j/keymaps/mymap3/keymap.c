@@ -1,6 +1,9 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
+#include "lib_ion/joystick.h"
+#include "lib_ion/macro.h"
+#include "lib_ion/scheduler.h"
 
 
 // Layer(=job) MAX 32jobs available
@@ -13,26 +16,31 @@
 
 
 void render_logo(void) {
+    // OLED_LOGO_BITMAP では起動時にビットマップで描いたロゴがそのまま残る
+    #ifndef OLED_LOGO_BITMAP
     oled_set_cursor(0, 0);
     oled_write_P(lhp_logo, false);
+    #endif
 }
 
+// Macros: played from housekeeping_task_user() without blocking the matrix scan
+static struct MACRO_STATE macro_state = MACRO_INIT;
+static const uint8_t PROGMEM macro_se_sh[] = {
+    MC_WRAP(MOD_LALT), MC_DELAY(10), MC_TAP(KC_4), MC_DELAY(20), MC_TAP(KC_9), MC_DELAY(10), MC_END
+};
+
 enum custom_keycodes {
+  // Macros: macros[keycode - MACRO_FIRST]
   SE_SH = SAFE_RANGE
 };
+#define MACRO_FIRST SE_SH
+
+static const uint8_t *const PROGMEM macros[] = {
+  [SE_SH - MACRO_FIRST] = macro_se_sh,
+};
 
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
-  switch (keycode) {
-     case SE_SH:
-      if (record->event.pressed) {
-         register_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) "4" SS_DELAY(10));
-           SEND_STRING(SS_DELAY(10) "9" SS_DELAY(10));
-         unregister_code(KC_LALT);
-      }
-      break;
-  }
-  return true;
+  return process_macro_keycode(&macro_state, keycode, record->event.pressed, MACRO_FIRST, macros, ARRAY_SIZE(macros));
 }
 
 
@@ -136,16 +144,37 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 
 
 
+// Stick: pins and calibration in the config.h of the board (lib_ion/joystick.h)
+static struct JOYSTICK_STATE js_state = JS_INIT;
+
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
      JOYSTICK_AXIS_VIRTUAL, // x
      JOYSTICK_AXIS_VIRTUAL  // y
 };
 
-void matrix_scan_user(void) {
+static void run_keymap_macros(void) {
+    run_macros(&macro_state);
+}
 
-    joystick_set_axis(0,analogReadPin(F4)/4 - 128);
-    joystick_set_axis(1,analogReadPin(F5)/4 - 128);  // if you use LHP14F or previous version, analogReadPin(D4)
+static void run_stick(void) {
+    read_joystick_angles(&js_state);
+    report_joystick(&js_state, 0, 1);
+}
+
+// Tasks of housekeeping_task_user() (lib_ion/scheduler.h)
+// TASK(function, period (ms), budget (us), background)
+static struct TASK tasks[] = {
+    // The stick is read and reported once per USB poll instead of once per matrix scan
+    TASK(run_stick, USB_POLLING_INTERVAL_MS, TASK_BUDGET_UNMEASURED, false),
+    TASK(run_keymap_macros, 0, TASK_BUDGET_UNMEASURED, false),
+};
+
+void keyboard_post_init_user(void) {
+    init_tasks(tasks, ARRAY_SIZE(tasks));
+}
 
+void housekeeping_task_user(void) {
+    run_tasks(tasks, ARRAY_SIZE(tasks));
 }
 
 
@@ -19,3 +19,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #pragma once
+
+// Measure the matrix scan time and show it on the PAR layer (see lhp14j/matrix.c)
+#define MATRIX_SCAN_BENCHMARK 1000
@@ -1,6 +1,7 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
+#include "lib_ion/joystick.h"
 
 #define RGB 0
 #define PAR 1
@@ -12,8 +13,11 @@
 
 
 void render_logo(void) {
+    // OLED_LOGO_BITMAP では起動時にビットマップで描いたロゴがそのまま残る
+    #ifndef OLED_LOGO_BITMAP
     oled_set_cursor(0, 0);
     oled_write_P(lhp_logo, false);
+    #endif
 }
 
 enum custom_keycodes {
@@ -55,8 +59,32 @@ void render_layer(void) {
     }
 }
 
+#ifdef MATRIX_SCAN_BENCHMARK
+void render_matrix_benchmark(void) {
+    // 1回のスキャンにかかる時間 (us): 1本ずつ読む場合 > ポートごとに読む場合
+    // 計測は初めて PAR レイヤーを表示したときに一度だけ (0.2秒ほど止まる)
+    static struct MATRIX_BENCHMARK matrix_benchmark;
+    static bool is_measured = false;
+    if (!is_measured) {
+        run_matrix_benchmark(&matrix_benchmark);
+        is_measured = true;
+    }
+    oled_set_cursor(0, 3);
+    oled_write_P(PSTR("Scan us:"), false);
+    oled_write(get_u16_str(matrix_benchmark.pin_us, ' '), false);
+    oled_write_P(PSTR(" >"), false);
+    oled_write(get_u16_str(matrix_benchmark.port_us, ' '), false);
+}
+#endif
+
 bool oled_task_user(void) {
     render_logo();
+    #ifdef MATRIX_SCAN_BENCHMARK
+    if (get_highest_layer(layer_state) == PAR) {
+        render_matrix_benchmark();
+        return false;
+    }
+    #endif
     render_layer();
     return false;
 }
@@ -134,6 +162,9 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 
 
 
+// Stick: pins and calibration in the config.h of the board (lib_ion/joystick.h)
+static struct JOYSTICK_STATE js_state = JS_INIT;
+
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
      JOYSTICK_AXIS_VIRTUAL, // x
      JOYSTICK_AXIS_VIRTUAL  // y
@@ -141,8 +172,8 @@ joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
 
 void matrix_scan_user(void) {
 
-    joystick_set_axis(0,analogReadPin(F4)/4 - 128);
-    joystick_set_axis(1,analogReadPin(F5)/4 - 128);  // if you use LHP14F or previous version, analogReadPin(D4)
+    read_joystick_angles(&js_state);
+    report_joystick(&js_state, 0, 1);
 
 }
 
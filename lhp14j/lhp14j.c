@@ -1 +1,13 @@
 #include "lhp14j.h"
+
+#ifdef OLED_LOGO_BITMAP
+#include "lib_ion/bitmap.h"
+// Generated by rules.mk from logo.pbm
+#include "logo_bitmap.h"
+
+void keyboard_post_init_kb(void) {
+    // ロゴは起動時に一度だけバッファに書き込む (キーマップはロゴの行を消去も上書きもしない)
+    render_bitmap_P(lhp_logo_bitmap, 0, 0, LHP_LOGO_BITMAP_WIDTH, LHP_LOGO_BITMAP_PAGES);
+    keyboard_post_init_user();
+}
+#endif
@@ -2,15 +2,31 @@
 
 #include "quantum.h"
 
+#ifdef MATRIX_SCAN_BENCHMARK
+// Time of one matrix scan, measured by run_matrix_benchmark() in matrix.c
+struct MATRIX_BENCHMARK {
+    uint16_t pin_us;   // reading the columns pin by pin like the QMK default scan
+    uint16_t port_us;  // reading the columns port by port (matrix_scan_custom)
+};
+void run_matrix_benchmark(struct MATRIX_BENCHMARK *result);
+#endif
+
 
 
 
 
+#if defined(OLED_LOGO_BITMAP)
+// The logo is drawn from logo.pbm by keyboard_post_init_kb() in lhp14j.c
+#elif defined(OLED_FONT_SUBSET)
+// The glyphs are renumbered for the subset font
+static const char PROGMEM lhp_logo[] = LHP_LOGO_SUBSET;
+#else
 static const char PROGMEM lhp_logo[] = {
     0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8C, 0x8D, 0x8E, 0x8F, 0x90, 0x91, 0x92, 0x93, 0x94,
     0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF, 0xB0, 0xB1, 0xB2, 0xB3, 0xB4,
     0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF, 0xD0, 0xD1, 0xD2, 0xD3, 0xD4, 0x00
 };
+#endif
 
 
 
@@ -0,0 +1,111 @@
+// LHP14j 専用のマトリクススキャン: 列のピンを1本ずつではなくポートごとにまとめて読む
+#include "lhp14j.h"
+#include "matrix.h"
+#include "atomic_util.h"
+#include "gpio.h"
+#include "timer.h"
+#include "wait.h"
+
+#ifndef MATRIX_IO_DELAY
+#    define MATRIX_IO_DELAY 30
+#endif
+
+static const pin_t row_pins[MATRIX_ROWS] = MATRIX_ROW_PINS;
+static const pin_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
+
+// 列のピン D4, F6, F7, B1, B3, B2, B6, C6, D2 (keyboard.json の matrix_pins.cols と同じ順番) のポートごとのマスク
+#define COL_MASK_B (_BV(1) | _BV(2) | _BV(3) | _BV(6))
+#define COL_MASK_C _BV(6)
+#define COL_MASK_D (_BV(2) | _BV(4))
+#define COL_MASK_F (_BV(6) | _BV(7))
+
+// ポートの bit ビット目を列 col のビットに移す。定数なのでシフトとマスクだけになる
+#define GATHER(port, bit, col) ((matrix_row_t)(((port) >> (bit)) & 1) << (col))
+
+static inline bool is_cols_high(void) {
+    return (PINB & COL_MASK_B) == COL_MASK_B && (PINC & COL_MASK_C) == COL_MASK_C && (PIND & COL_MASK_D) == COL_MASK_D && (PINF & COL_MASK_F) == COL_MASK_F;
+}
+
+static matrix_row_t read_cols(void) {
+    // 押されたキーの列は Low になるので反転して、4つのポートを1回ずつ読む
+    uint8_t b = ~PINB & COL_MASK_B;
+    uint8_t c = ~PINC & COL_MASK_C;
+    uint8_t d = ~PIND & COL_MASK_D;
+    uint8_t f = ~PINF & COL_MASK_F;
+    if ((b | c | d | f) == 0) return 0;
+    return GATHER(d, 4, 0) | GATHER(f, 6, 1) | GATHER(f, 7, 2) | GATHER(b, 1, 3) | GATHER(b, 3, 4) | GATHER(b, 2, 5) | GATHER(b, 6, 6) | GATHER(c, 6, 7) | GATHER(d, 2, 8);
+}
+
+static void select_row(uint8_t row) {
+    ATOMIC_BLOCK_FORCEON {
+        gpio_set_pin_output(row_pins[row]);
+        gpio_write_pin_low(row_pins[row]);
+    }
+}
+
+static void unselect_row(uint8_t row) {
+    ATOMIC_BLOCK_FORCEON {
+        gpio_set_pin_input_high(row_pins[row]);
+    }
+}
+
+void matrix_init_custom(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        unselect_row(row);
+    }
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        ATOMIC_BLOCK_FORCEON {
+            gpio_set_pin_input_high(col_pins[col]);
+        }
+    }
+}
+
+bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+    bool changed = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        select_row(row);
+        matrix_output_select_delay();
+        matrix_row_t cols = read_cols();
+        unselect_row(row);
+        // MATRIX_IO_DELAY を上限に、全部の列が High に戻るまで待つ (どの列も Low でなければ待たない)
+        // 読んだ値が 0 でも、読んだ後に行を戻すまでにチャタリングで閉じたキーの列は Low になっているのでピンを見る
+        for (uint8_t i = MATRIX_IO_DELAY; i > 0 && !is_cols_high(); i--) {
+            wait_us(1);
+        }
+        changed |= current_matrix[row] != cols;
+        current_matrix[row] = cols;
+    }
+    return changed;
+}
+
+#ifdef MATRIX_SCAN_BENCHMARK
+// QMK の標準のスキャンと同じく、1本ずつ読んで毎回 MATRIX_IO_DELAY だけ待つ (比較用)
+static void scan_by_pin(matrix_row_t current_matrix[]) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t cols = 0;
+        select_row(row);
+        matrix_output_select_delay();
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (gpio_read_pin(col_pins[col]) == 0) cols |= (matrix_row_t)1 << col;
+        }
+        unselect_row(row);
+        matrix_output_unselect_delay(row, cols != 0);
+        current_matrix[row] = cols;
+    }
+}
+
+void run_matrix_benchmark(struct MATRIX_BENCHMARK *result) {
+    // MATRIX_SCAN_BENCHMARK 回 (1000 なら経過 ms がそのまま1回あたりの us) スキャンして時間を比べる
+    matrix_row_t buffer[MATRIX_ROWS] = {0};
+    uint32_t start = timer_read32();
+    for (uint16_t i = 0; i < MATRIX_SCAN_BENCHMARK; i++) {
+        scan_by_pin(buffer);
+    }
+    result->pin_us = (uint32_t)timer_elapsed32(start) * 1000 / MATRIX_SCAN_BENCHMARK;
+    start = timer_read32();
+    for (uint16_t i = 0; i < MATRIX_SCAN_BENCHMARK; i++) {
+        matrix_scan_custom(buffer);
+    }
+    result->port_us = (uint32_t)timer_elapsed32(start) * 1000 / MATRIX_SCAN_BENCHMARK;
+}
+#endif
@@ -1,4 +1,46 @@
 JOYSTICK_ENABLE = yes
 JOYSTICK_DRIVER = analog
+# Mouse mode of the stick (lib_ion/joystick.h)
+POINTING_DEVICE_ENABLE = yes
+POINTING_DEVICE_DRIVER = custom
 
 ANALOG_DRIVER_REQUIRED = yes
+
+# Matrix: read the columns port by port instead of pin by pin (see matrix.c)
+CUSTOM_MATRIX = lite
+SRC += matrix.c
+
+SRC += lib_ion/joystick.c lib_ion/macro.c
+# Tasks of housekeeping_task_user() with periods and run time counters (lib_ion/scheduler.h)
+SRC += lib_ion/scheduler.c lib_ion/timer_us.c
+
+# Debounce: send a press at once and a release after it is stable, per key (see lib_ion/eager_debounce.h)
+# DEBOUNCE_TYPE = sym_defer_g goes back to the QMK default
+DEBOUNCE_TYPE ?= custom
+ifeq ($(strip $(DEBOUNCE_TYPE)), custom)
+    SRC += lib_ion/eager_debounce.c
+endif
+
+LHP_BOARD_DIR := $(dir $(lastword $(MAKEFILE_LIST)))
+
+# Bitmap logo: draw the logo once from a compressed bitmap instead of font glyphs (see lib_ion/tools/bitmap.py)
+OLED_LOGO_BITMAP ?= yes
+ifeq ($(strip $(OLED_LOGO_BITMAP)), yes)
+    LOGO_BITMAP_LOG := $(shell python3 $(LHP_BOARD_DIR)../lib_ion/tools/bitmap.py --name lhp_logo_bitmap \
+        $(LHP_BOARD_DIR)logo.pbm $(LHP_BOARD_DIR)logo_bitmap.h)
+    $(info $(LOGO_BITMAP_LOG))
+    OPT_DEFS += -DOLED_LOGO_BITMAP
+    SRC += lib_ion/bitmap.c
+endif
+
+# Subset font: keep only the glyphs printed by the keymaps and lib_ion (see lib_ion/tools/font_subset.py)
+# The logo glyphs are kept only when the logo is drawn with the font
+OLED_FONT_SUBSET ?= yes
+ifeq ($(strip $(OLED_FONT_SUBSET)), yes)
+    FONT_SUBSET_LOG := $(shell python3 $(LHP_BOARD_DIR)../lib_ion/tools/font_subset.py \
+        --font $(LHP_BOARD_DIR)glcdfont_lhp14.c $(if $(filter yes,$(strip $(OLED_LOGO_BITMAP))),,--logo $(LHP_BOARD_DIR)lhp14j.h) \
+        --out-font $(LHP_BOARD_DIR)glcdfont_lhp14_subset.c --out-header $(LHP_BOARD_DIR)font_subset.h \
+        $(LHP_BOARD_DIR)keymaps $(LHP_BOARD_DIR)../lib_ion)
+    $(info $(FONT_SUBSET_LOG))
+    OPT_DEFS += -DOLED_FONT_SUBSET
+endif
@@ -6,6 +6,23 @@
 #define JOYSTICK_BUTTON_COUNT 1
 #define JOYSTICK_AXIS_COUNT 2
 #define JOYSTICK_AXIS_RESOLUTION 8
+// Interval (ms) of the keyboard, mouse and joystick endpoints: 1 ms is the fastest for full speed USB
+#define USB_POLLING_INTERVAL_MS 1
+// Read the stick at the native 12 bits of the RP2040 (QMK reads 10 bits by default), see lib_ion/stick_adc.h
+#define ADC_RESOLUTION 12
+
+// Stick for lib_ion/joystick.h. Not measured: the whole ADC range (same as the former analogReadPin() / 4 - 128)
+#define JS_PIN_X GP29
+#define JS_PIN_Y GP28
+// Default calibration: a keymap can use its own by setting all six in its config.h (#undef, then #define)
+#ifndef JS_X_LOW
+#define JS_X_LOW 0
+#define JS_X_MID JS_ADC_CENTER
+#define JS_X_HIGH JS_ADC_MAX
+#define JS_Y_LOW 0
+#define JS_Y_MID JS_ADC_CENTER
+#define JS_Y_HIGH JS_ADC_MAX
+#endif
 
 #define OLED_TIMEOUT 0
 
@@ -4,6 +4,9 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
+#include "lib_ion/joystick.h"
+#include "lib_ion/macro.h"
+#include "lib_ion/scheduler.h"
 
 #define SAM 0
 #define SCH 1
@@ -43,48 +46,51 @@ void render_logo(void) {
     oled_write_P(lhp_logo, false);
 }
 
+// Macros: played from housekeeping_task_user() without blocking the matrix scan
+static struct MACRO_STATE macro_state = MACRO_INIT;
+static const uint8_t PROGMEM macro_ac_ph[] = {
+    MC_WRAP(MOD_LALT), MC_DELAY(10), MC_TAP(KC_2), MC_DELAY(10),
+    MC_UNWRAP, MC_DELAY(10), MC_TAP(KC_RPRN), MC_DELAY(10), MC_END
+};
+static const uint8_t PROGMEM macro_hc_hb[] = {
+    MC_WRAP(MOD_LALT), MC_DELAY(10), MC_TAP(KC_7), MC_DELAY(20), MC_TAP(KC_8), MC_DELAY(10), MC_END
+};
+static const uint8_t PROGMEM macro_se_sh[] = {
+    MC_WRAP(MOD_LALT), MC_PRESS(KC_4), MC_DELAY(10), MC_RELEASE(KC_4),
+    MC_PRESS(KC_9), MC_DELAY(10), MC_RELEASE(KC_9), MC_END
+};
+static const uint8_t PROGMEM macro_tk_gg[] = {
+    MC_WRAP(MOD_LALT), MC_DELAY(10), MC_TAP(KC_8), MC_DELAY(20), MC_TAP(KC_9), MC_DELAY(10), MC_END
+};
+static const uint8_t PROGMEM macro_pot[] = {
+    MC_WRAP(MOD_LALT), MC_PRESS(KC_0), MC_DELAY(10), MC_RELEASE(KC_0), MC_END
+};
+
 enum custom_keycodes {
-  AC_PH = SAFE_RANGE,
-  HC_HB,
-  SE_SH,
-  RGBRST,
-  TK_GG,
+  RGBRST = SAFE_RANGE,
   RPT_SD,
   RPT_JP,
   RPT_DD,
   RPT_POT,
+  // Macros: macros[keycode - MACRO_FIRST]
+  AC_PH,
+  HC_HB,
+  SE_SH,
+  TK_GG,
+};
+#define MACRO_FIRST AC_PH
+
+static const uint8_t *const PROGMEM macros[] = {
+  [AC_PH - MACRO_FIRST] = macro_ac_ph,
+  [HC_HB - MACRO_FIRST] = macro_hc_hb,
+  [SE_SH - MACRO_FIRST] = macro_se_sh,
+  [TK_GG - MACRO_FIRST] = macro_tk_gg,
 };
 
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+  if (!process_macro_keycode(&macro_state, keycode, record->event.pressed, MACRO_FIRST, macros, ARRAY_SIZE(macros))) return false;
   switch (keycode) {
     
-    case AC_PH:
-      if (record->event.pressed) {
-         register_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) "2" SS_DELAY(10));
-         unregister_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) ")" SS_DELAY(10));
-      }
-      break;
-    
-    case HC_HB:
-      if (record->event.pressed) {
-         register_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) "7" SS_DELAY(10));
-           SEND_STRING(SS_DELAY(10) "8" SS_DELAY(10));
-         unregister_code(KC_LALT);
-      }
-      break;
-    
-    case SE_SH:
-      if (record->event.pressed) {
-         register_code(KC_LALT);
-           tap_code_delay(KC_4,10);
-           tap_code_delay(KC_9,10);
-         unregister_code(KC_LALT);
-      }
-      break;
-    
     case RGBRST:
       #ifdef RGBLIGHT_ENABLE
         if (record->event.pressed) {
@@ -94,15 +100,6 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
       #endif
       break;
     
-    case TK_GG:
-      if (record->event.pressed) {
-         register_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) "8" SS_DELAY(10));
-           SEND_STRING(SS_DELAY(10) "9" SS_DELAY(10));
-         unregister_code(KC_LALT);
-      }
-      break;
-    
     case RPT_SD:
       if (record->event.pressed) {				//When key is pressed
             tap_code(KC_EQL);					//Type key you want to repeat (in this case =)
@@ -152,16 +149,24 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 
 
 
+// Stick: pins and calibration in the config.h of the board (lib_ion/joystick.h)
+static struct JOYSTICK_STATE js_state = JS_INIT;
+
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
      JOYSTICK_AXIS_VIRTUAL, // x
      JOYSTICK_AXIS_VIRTUAL  // y
 };
 
-void matrix_scan_user(void) {
+static void run_keymap_macros(void) {
+    run_macros(&macro_state);
+}
 
-    joystick_set_axis(0,analogReadPin(GP29)/4 - 128);
-    joystick_set_axis(1,analogReadPin(GP28)/4 - 128);
+static void run_stick(void) {
+    read_joystick_angles(&js_state);
+    report_joystick(&js_state, 0, 1);
+}
 
+static void run_repeats(void) {
     if ((repeat_sd) && (timer_elapsed(timer_sd) > 50)) {		//If "repeat_sd" is true and 50 ms has elapsed
          tap_code(KC_EQL);						//Type key you want to repeat
        timer_sd = timer_read();						//Reset timer (also could do with modulus % and not resetting timer, unsure which is faster)
@@ -178,13 +183,29 @@ void matrix_scan_user(void) {
     }
     
     if ((repeat_pot) && (timer_elapsed(timer_pot) > 100)) {
-         register_code(KC_LALT);
-           tap_code_delay(KC_0,10);
-         unregister_code(KC_LALT);
-       timer_dd = timer_read();
+         start_macro(&macro_state, macro_pot);
+       timer_pot = timer_read();
     }
 }
 
+// Tasks of housekeeping_task_user() (lib_ion/scheduler.h)
+// TASK(function, period (ms), budget (us), background)
+static struct TASK tasks[] = {
+    // The stick is read and reported once per USB poll instead of once per matrix scan
+    TASK(run_stick, USB_POLLING_INTERVAL_MS, TASK_BUDGET_UNMEASURED, false),
+    // RPT_* repeat on their own timers, checked every ms
+    TASK(run_repeats, 1, TASK_BUDGET_UNMEASURED, false),
+    TASK(run_keymap_macros, 0, TASK_BUDGET_UNMEASURED, false),
+};
+
+void keyboard_post_init_user(void) {
+    init_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
+void housekeeping_task_user(void) {
+    run_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
 
 
 void render_layer(void) {
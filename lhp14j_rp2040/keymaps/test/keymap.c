@@ -4,6 +4,7 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
+#include "lib_ion/joystick.h"
 
 #define RGB 0
 #define PAR 1
@@ -137,6 +138,9 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 
 
 
+// Stick: pins and calibration in the config.h of the board (lib_ion/joystick.h)
+static struct JOYSTICK_STATE js_state = JS_INIT;
+
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
      JOYSTICK_AXIS_VIRTUAL, // x
      JOYSTICK_AXIS_VIRTUAL  // y
@@ -144,8 +148,8 @@ joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
 
 void matrix_scan_user(void) {
 
-    joystick_set_axis(0,analogReadPin(GP29)/4 - 128);
-    joystick_set_axis(1,analogReadPin(GP28)/4 - 128);
+    read_joystick_angles(&js_state);
+    report_joystick(&js_state, 0, 1);
 
 }
 
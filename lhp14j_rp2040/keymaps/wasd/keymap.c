@@ -4,6 +4,9 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
+#include "lib_ion/stick_adc.h"
+#include "lib_ion/macro.h"
+#include "lib_ion/scheduler.h"
 
 #define SAM 0
 #define SCH 1
@@ -24,7 +27,7 @@
 #define RGB 13
 
 
-static int actuation = 256; // actuation point for arrows (0-511)
+static int actuation = JS_ADC_10BIT(256); // actuation point for arrows (0 - JS_ADC_CENTER - 1)
 bool arrows[4];
 
 void render_logo(void) {
@@ -32,40 +35,42 @@ void render_logo(void) {
     oled_write_P(lhp_logo, false);
 }
 
+// Macros: played from housekeeping_task_user() without blocking the matrix scan
+static struct MACRO_STATE macro_state = MACRO_INIT;
+static const uint8_t PROGMEM macro_ac_ph[] = {
+    MC_WRAP(MOD_LALT), MC_DELAY(10), MC_TAP(KC_2), MC_DELAY(10),
+    MC_UNWRAP, MC_DELAY(10), MC_TAP(KC_RPRN), MC_DELAY(10), MC_END
+};
+static const uint8_t PROGMEM macro_hc_hb[] = {
+    MC_WRAP(MOD_LALT), MC_DELAY(10), MC_TAP(KC_7), MC_DELAY(20), MC_TAP(KC_8), MC_DELAY(10), MC_END
+};
+static const uint8_t PROGMEM macro_se_sh[] = {
+    MC_WRAP(MOD_LALT), MC_DELAY(10), MC_TAP(KC_4), MC_DELAY(20), MC_TAP(KC_9), MC_DELAY(10), MC_END
+};
+static const uint8_t PROGMEM macro_tk_gg[] = {
+    MC_WRAP(MOD_LALT), MC_DELAY(10), MC_TAP(KC_8), MC_DELAY(20), MC_TAP(KC_9), MC_DELAY(10), MC_END
+};
+
 enum custom_keycodes {
-  AC_PH = SAFE_RANGE,
+  RGBRST = SAFE_RANGE,
+  // Macros: macros[keycode - MACRO_FIRST]
+  AC_PH,
   HC_HB,
   SE_SH,
-  RGBRST,
-  TK_GG
+  TK_GG,
+};
+#define MACRO_FIRST AC_PH
+
+static const uint8_t *const PROGMEM macros[] = {
+  [AC_PH - MACRO_FIRST] = macro_ac_ph,
+  [HC_HB - MACRO_FIRST] = macro_hc_hb,
+  [SE_SH - MACRO_FIRST] = macro_se_sh,
+  [TK_GG - MACRO_FIRST] = macro_tk_gg,
 };
 
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+  if (!process_macro_keycode(&macro_state, keycode, record->event.pressed, MACRO_FIRST, macros, ARRAY_SIZE(macros))) return false;
   switch (keycode) {
-    case AC_PH:
-      if (record->event.pressed) {
-         register_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) "2" SS_DELAY(10));
-         unregister_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) ")" SS_DELAY(10));
-      }
-      break;
-    case HC_HB:
-      if (record->event.pressed) {
-         register_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) "7" SS_DELAY(10));
-           SEND_STRING(SS_DELAY(10) "8" SS_DELAY(10));
-         unregister_code(KC_LALT);
-      }
-      break;
-    case SE_SH:
-      if (record->event.pressed) {
-         register_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) "4" SS_DELAY(10));
-           SEND_STRING(SS_DELAY(10) "9" SS_DELAY(10));
-         unregister_code(KC_LALT);
-      }
-      break;
     case RGBRST:
       #ifdef RGBLIGHT_ENABLE
         if (record->event.pressed) {
@@ -74,14 +79,6 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         }
       #endif
       break;
-    case TK_GG:
-      if (record->event.pressed) {
-         register_code(KC_LALT);
-           SEND_STRING(SS_DELAY(10) "8" SS_DELAY(10));
-           SEND_STRING(SS_DELAY(10) "9" SS_DELAY(10));
-         unregister_code(KC_LALT);
-      }
-      break;
   }
   return true;
 }
@@ -89,42 +86,61 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 
 
 
-void matrix_scan_user(void) {
+static void run_keymap_macros(void) {
+    run_macros(&macro_state);
+}
 
-        if (!arrows[0] && analogReadPin(GP29) - 512 > actuation){
+static void run_stick(void) {
+        if (!arrows[0] && analogReadPin(GP29) - JS_ADC_CENTER > actuation){
             arrows[0] = true;
             register_code16(KC_D);
         }
-        else if (arrows[0] &&  analogReadPin(GP29) - 512 < actuation){
+        else if (arrows[0] &&  analogReadPin(GP29) - JS_ADC_CENTER < actuation){
             arrows[0] = false;
             unregister_code16(KC_D);
         }
-        if (!arrows[1] && analogReadPin(GP29) - 512 < -actuation){
+        if (!arrows[1] && analogReadPin(GP29) - JS_ADC_CENTER < -actuation){
             arrows[1] = true;
             register_code16(KC_A);
         }
-        else if (arrows[1] && analogReadPin(GP29) - 512 > -actuation){
+        else if (arrows[1] && analogReadPin(GP29) - JS_ADC_CENTER > -actuation){
             arrows[1] = false;
             unregister_code16(KC_A);
         }
-        if (!arrows[2] && analogReadPin(GP28) - 512 > actuation){
+        if (!arrows[2] && analogReadPin(GP28) - JS_ADC_CENTER > actuation){
             arrows[2] = true;
             register_code16(KC_S);
         }
-        else if (arrows[2] &&  analogReadPin(GP28) - 512 < actuation){
+        else if (arrows[2] &&  analogReadPin(GP28) - JS_ADC_CENTER < actuation){
             arrows[2] = false;
             unregister_code16(KC_S);
         }
-        if (!arrows[3] && analogReadPin(GP28) - 512 < -actuation){
+        if (!arrows[3] && analogReadPin(GP28) - JS_ADC_CENTER < -actuation){
             arrows[3] = true;
             register_code16(KC_W);
         }
-        else if (arrows[3] && analogReadPin(GP28) - 512 > -actuation){
+        else if (arrows[3] && analogReadPin(GP28) - JS_ADC_CENTER > -actuation){
             arrows[3] = false;
             unregister_code16(KC_W); 
         }
 }
 
+// Tasks of housekeeping_task_user() (lib_ion/scheduler.h)
+// TASK(function, period (ms), budget (us), background)
+static struct TASK tasks[] = {
+    // The stick is read and reported once per USB poll instead of once per matrix scan
+    TASK(run_stick, USB_POLLING_INTERVAL_MS, TASK_BUDGET_UNMEASURED, false),
+    TASK(run_keymap_macros, 0, TASK_BUDGET_UNMEASURED, false),
+};
+
+void keyboard_post_init_user(void) {
+    init_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
+void housekeeping_task_user(void) {
+    run_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
 
 
 void render_layer(void) {
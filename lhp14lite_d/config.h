@@ -7,10 +7,31 @@
 #define JOYSTICK_BUTTON_COUNT 2
 #define JOYSTICK_AXIS_COUNT 2
 #define JOYSTICK_AXIS_RESOLUTION 8
+// Interval (ms) of the keyboard, mouse and joystick endpoints: 1 ms is the fastest for full speed USB
+#define USB_POLLING_INTERVAL_MS 1
+
+// Stick for lib_ion/joystick.h: ADC measured values (X is inverted: the left end is the highest)
+#define JS_PIN_X F5
+#define JS_PIN_Y F4
+// Default calibration: a keymap can use its own by setting all six in its config.h (#undef, then #define)
+#ifndef JS_X_LOW
+#define JS_X_LOW 784
+#define JS_X_MID 444
+#define JS_X_HIGH 172
+#define JS_Y_LOW 244
+#define JS_Y_MID 532
+#define JS_Y_HIGH 822
+#endif
 
 #define OLED_TIMEOUT 0
 
+#ifdef OLED_FONT_SUBSET
+// Generated by rules.mk
+#include "font_subset.h"
+#define OLED_FONT_H "./lhp14lite_d/glcdfont_lhp14lite_subset.c"
+#else
 #define OLED_FONT_H "./lhp14lite_d/glcdfont_lhp14lite.c"
+#endif
 
 #define LAYER_STATE_8BIT
 
@@ -4,19 +4,9 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
-
-// ADC Measured value
-#define min_x 150
-#define med_x 479
-#define max_x 782
-
-#define min_y 200
-#define med_y 598
-#define max_y 989
-
-#define adc_x F5
-#define adc_y F4
-
+#include "lib_ion/joystick.h"
+#include "lib_ion/macro.h"
+#include "lib_ion/scheduler.h"
 
 #define SAM 0
 #define SCH 1
@@ -39,27 +29,31 @@ void render_logo(void) {
     oled_write_P(lhp_logo, false);
 };
 
+// Macros: played from housekeeping_task_user() without blocking the matrix scan
+static struct MACRO_STATE macro_state = MACRO_INIT;
+static const uint8_t PROGMEM macro_sr_cs[] = {
+    MC_WRAP(MOD_LALT), MC_TAP(KC_0), MC_UNWRAP, MC_TAP(KC_MINS), MC_END
+};
+static const uint8_t PROGMEM macro_rr_rd[] = {
+    MC_TAP(LCA(KC_2)), MC_TAP(KC_5), MC_END
+};
+
 enum custom_keycodes {
-  SR_CS = SAFE_RANGE,
+  RGBRST = SAFE_RANGE,
+  // Macros: macros[keycode - MACRO_FIRST]
+  SR_CS,
   RR_RD,
-  RGBRST
+};
+#define MACRO_FIRST SR_CS
+
+static const uint8_t *const PROGMEM macros[] = {
+  [SR_CS - MACRO_FIRST] = macro_sr_cs,
+  [RR_RD - MACRO_FIRST] = macro_rr_rd,
 };
 
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+  if (!process_macro_keycode(&macro_state, keycode, record->event.pressed, MACRO_FIRST, macros, ARRAY_SIZE(macros))) return false;
   switch (keycode) {
-    case SR_CS:
-      if (record->event.pressed) {
-        SEND_STRING(SS_LALT("0") "-");
-      }
-      break;
-    case RR_RD:
-      if (record->event.pressed) {
-		register_code(KC_LCTL);
-        SEND_STRING(SS_LALT("2"));
-        unregister_code(KC_LCTL);
-        SEND_STRING("5");
-      }
-      break;
     case RGBRST:
       #ifdef RGBLIGHT_ENABLE
         if (record->event.pressed) {
@@ -72,12 +66,40 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
   return true;
 };
 
+static void run_keymap_macros(void) {
+    run_macros(&macro_state);
+}
+
+
+// Stick: pins and calibration in the config.h of the board (lib_ion/joystick.h)
+static struct JOYSTICK_STATE js_state = JS_INIT;
 
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
-    [0] = JOYSTICK_AXIS_IN(adc_x, max_x, med_x, min_x),
-    [1] = JOYSTICK_AXIS_IN(adc_y, min_y, med_y, max_y),
+    [0] = JOYSTICK_AXIS_VIRTUAL,
+    [1] = JOYSTICK_AXIS_VIRTUAL,
 };
 
+static void run_stick(void) {
+    read_joystick_angles(&js_state);
+    report_joystick(&js_state, 0, 1);
+}
+
+// Tasks of housekeeping_task_user() (lib_ion/scheduler.h)
+// TASK(function, period (ms), budget (us), background)
+static struct TASK tasks[] = {
+    // The stick is read and reported once per USB poll instead of once per matrix scan
+    TASK(run_stick, USB_POLLING_INTERVAL_MS, TASK_BUDGET_UNMEASURED, false),
+    TASK(run_keymap_macros, 0, TASK_BUDGET_UNMEASURED, false),
+};
+
+void keyboard_post_init_user(void) {
+    init_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
+void housekeeping_task_user(void) {
+    run_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
 
 
 void render_layer(void) {
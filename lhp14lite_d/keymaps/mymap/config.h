@@ -21,4 +21,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 #define NO_ACTION_ONESHOT
 
-#define OLED_BRIGHTNESS 0
\ No newline at end of file
+#define OLED_BRIGHTNESS 0
+
+// EEPROM block for lib_ion/settings.c (struct SETTINGS)
+#define EECONFIG_USER_DATA_SIZE 128
+
+// 16 bit stick axes (-32767 - 32767) for fine aiming, the board default is 8 bits
+#undef JOYSTICK_AXIS_RESOLUTION
+#define JOYSTICK_AXIS_RESOLUTION 16
+
+#ifdef GAMEPAD_REPORT
+// Hat switch and 16 buttons in the joystick report for lib_ion/gamepad.c
+#undef JOYSTICK_BUTTON_COUNT
+#define JOYSTICK_BUTTON_COUNT 16
+#define JOYSTICK_HAS_HAT
+#endif
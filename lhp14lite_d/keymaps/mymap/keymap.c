@@ -4,6 +4,19 @@
 #include QMK_KEYBOARD_H
 #include "lib_ion/oled.h"
 #include "lib_ion/joystick.h"
+#include "lib_ion/layer.h"
+#include "lib_ion/gesture.h"
+#include "lib_ion/settings.h"
+#include "lib_ion/macro.h"
+#include "lib_ion/scheduler.h"
+#ifdef GAMEPAD_REPORT
+#include "lib_ion/gamepad.h"
+#endif
+#ifdef RAW_ENABLE
+#include "raw_hid.h"
+#include "lib_ion/rawhid.h"
+#include "lib_ion/telemetry.h"
+#endif
 
 // Button repeating
 #define JS_RAPID_BUTTON 1
@@ -11,10 +24,24 @@
 // Joystick configurations
 // Enable/disable stick (Buttons are always enabled)
 static struct JOYSTICK_STATE js_state = JS_INIT;
+// JS_MO_TOGGLE flips the mouse mode of the layer profile. It is kept apart from js_state.profile,
+// which apply_settings() overwrites on every layer change, so the toggle survives the layer keys.
 static bool is_joystick_mouse = false;
 static struct JOYSTICK_RAPID_STATE js_rapid_state = JS_RAPID_INIT(JS_RAPID_BUTTON);
+#ifdef JS_DEBUG_ENABLED
+static struct JOYSTICK_WIDGET_STATE js_widget = JS_WIDGET_INIT;
+#endif
 
 static bool is_oled_enabled = true;
+static struct OLED_PAGE_STATE oled_page = OLED_PAGE_INIT;
+static struct SCAN_STATS scan_stats = SCAN_STATS_INIT;
+static struct LAYER_CACHE layer_cache = LAYER_CACHE_INIT;
+static uint8_t rendered_layer_seq = 0;
+static uint8_t js_profile_seq = 0;
+static struct GESTURE_STATE js_gesture = GESTURE_INIT;
+#ifdef RAW_ENABLE
+static struct TELEMETRY_STATE telemetry = TELEMETRY_INIT;
+#endif
 
 // Layers
 // Max 32 layers available
@@ -24,6 +51,29 @@ static bool is_oled_enabled = true;
 #define FFXIV 3
 #define TEST 4
 
+// Joystick profiles for each layer (the layers not listed use MAIN)
+// JS_PROFILE(mouse mode, curve, deadzone, rapid fire interval (ms), mouse speed)
+static const struct JOYSTICK_PROFILE PROGMEM js_profiles[] = {
+    [MAIN] = JS_PROFILE_DEFAULT,
+    [NUMPADS] = JS_PROFILE_DEFAULT,
+    [FUNCTIONS] = JS_PROFILE_DEFAULT,
+    [FFXIV] = JS_PROFILE(false, JS_CURVE_QUADRATIC, JS_DEADZONE, JS_RAPID_INTERVAL, JS_MOUSE_SPEED),
+};
+_Static_assert(ARRAY_SIZE(js_profiles) <= SETTINGS_PROFILE_COUNT, "SETTINGS_PROFILE_COUNT is smaller than the profiles");
+// Profiles, calibration and OLED periods changed over raw HID (lib_ion/tools/ion_hid.py) and saved to the EEPROM
+static struct SETTINGS_STATE settings = SETTINGS_INIT(js_profiles);
+
+// Stick gestures on the FUNCTIONS layer (the stick is not sent as a gamepad on this layer)
+static const uint16_t PROGMEM js_gestures[GESTURE_COUNT] = {
+    [GESTURE_FLICK + GESTURE_UP] = KC_VOLU,
+    [GESTURE_FLICK + GESTURE_DOWN] = KC_VOLD,
+    [GESTURE_FLICK + GESTURE_LEFT] = KC_MPRV,
+    [GESTURE_FLICK + GESTURE_RIGHT] = KC_MNXT,
+    [GESTURE_HOLD + GESTURE_DOWN] = KC_MUTE,
+    [GESTURE_HALF_CW] = KC_MPLY,
+    [GESTURE_HALF_CCW] = KC_MSTP,
+};
+
 enum custom_keycodes {
     RGBRST = SAFE_RANGE,
     DOUBLE_ZERO,
@@ -31,9 +81,36 @@ enum custom_keycodes {
     JS_RAPID,
     JS_MO_TOGGLE,
     OLED_TOGGLE,
+    OLED_PAGE,
+    HAT_UP,
+    HAT_RIGHT,
+    HAT_DOWN,
+    HAT_LEFT,
+    JS_HAT_STICK,
 };
 
+// Macros: played by the run_keymap_macros() task without blocking the matrix scan
+static struct MACRO_STATE macro_state = MACRO_INIT;
+static const uint8_t PROGMEM macro_double_zero[] = {
+    MC_TAP(KC_0), MC_TAP(KC_0), MC_END
+};
+// macros[keycode - MACRO_FIRST]
+#define MACRO_FIRST DOUBLE_ZERO
+static const uint8_t *const PROGMEM macros[] = {
+    [DOUBLE_ZERO - MACRO_FIRST] = macro_double_zero,
+};
+
+#ifdef GAMEPAD_REPORT
+static struct GAMEPAD_STATE gamepad = GAMEPAD_INIT(HAT_UP);
+#endif
+
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    log_key_event(&scan_stats, record);
+    #ifdef GAMEPAD_REPORT
+    // ボタンとハットスイッチはレポートを変えるだけで、送るのは run_stick_reporter()
+    if (!process_gamepad(&gamepad, keycode, record)) return false;
+    #endif
+    if (!process_macro_keycode(&macro_state, keycode, record->event.pressed, MACRO_FIRST, macros, ARRAY_SIZE(macros))) return false;
     switch (keycode) {
         case RGBRST:
             #ifdef RGBLIGHT_ENABLE
@@ -43,11 +120,6 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
             }
             #endif
             break;
-        case DOUBLE_ZERO:
-            if (record->event.pressed) {
-                SEND_STRING("00");
-            }
-            break;
         case JS_TOGGLE:
             if (record->event.pressed) {
                 js_state.enabled = !js_state.enabled;
@@ -69,25 +141,174 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
                 if (is_oled_enabled) oled_on();
                 else oled_off();
             }
+            break;
+        case OLED_PAGE:
+            if (record->event.pressed) {
+                next_oled_page(&oled_page);
+            }
+            break;
+        case JS_HAT_STICK:
+            #ifdef GAMEPAD_REPORT
+            if (record->event.pressed) {
+                gamepad.stick_hat = !gamepad.stick_hat;
+            }
+            #endif
+            break;
     }
     return true;
 };
 
+void post_process_record_user(uint16_t keycode, keyrecord_t *record) {
+    count_key_latency(&scan_stats, record);
+}
+
+layer_state_t layer_state_set_user(layer_state_t state) {
+    return update_layer_cache(&layer_cache, state);
+}
+
+// プロファイルのマウスモードを JS_MO_TOGGLE で反転したもの
+static bool is_stick_mouse(void) {
+    return js_state.profile.is_mouse != is_joystick_mouse;
+}
+
 void matrix_scan_user(void) {
-    run_joystick_rapid(&js_rapid_state);
+    // スキャンそのものの回数と間隔を数えるので、タスクにせずスキャンごとに呼ぶ
+    count_scan(&scan_stats);
+}
+
+static void run_profile_swap(void) {
+    // レイヤーが変わったときだけプロファイルを入れ替える
+    if (is_layer_changed(&layer_cache, &js_profile_seq)) {
+        apply_settings(&settings, &js_state, &js_rapid_state, &oled_page, layer_cache.layer);
+    }
+}
+
+static void run_stick_sampler(void) {
     read_joystick_angles(&js_state);
-    if (!is_joystick_mouse) report_joystick(&js_state, 0, 1);
-    else report_joystick_as_mouse(&js_state);
+    #ifdef RAW_ENABLE
+    run_telemetry(&telemetry, &js_state);
+    #endif
 }
 
+static void run_stick_reporter(void) {
+    // ゲームパッドの軸として送るスティック (ジェスチャーとマウスモードでは NULL にして中央のままにしておく)
+    struct JOYSTICK_STATE *gamepad_stick = NULL;
+    if (layer_cache.layer == FUNCTIONS) {
+        uint16_t keycode = gesture_keycode(js_gestures, run_gesture(&js_gesture, js_state.x, js_state.y, timer_read()));
+        if (keycode != KC_NO) tap_code16(keycode);
+    } else if (is_stick_mouse()) {
+        report_joystick_as_mouse(&js_state);
+    } else {
+        gamepad_stick = &js_state;
+    }
+    #ifdef GAMEPAD_REPORT
+    // ハットスイッチのキーとボタンはスティックの使い方によらず送る。モードを変えるとスティックの分は中央に戻る
+    bool is_sent = report_gamepad(&gamepad, gamepad_stick);
+    #else
+    bool is_sent = false;
+    if (gamepad_stick != NULL) {
+        is_sent = report_joystick(gamepad_stick, 0, 1);
+    } else {
+        joystick_set_axis(0, 0);
+        joystick_set_axis(1, 0);
+    }
+    #endif
+    if (is_sent) count_report(&scan_stats, REPORT_JOYSTICK);
+}
+
+static void run_rapid_fire(void) {
+    #ifdef GAMEPAD_REPORT
+    // ボタンを変えるだけで、送るのと数えるのは run_stick_reporter()
+    run_joystick_rapid(&js_rapid_state);
+    #else
+    if (run_joystick_rapid(&js_rapid_state)) count_report(&scan_stats, REPORT_JOYSTICK);
+    #endif
+}
+
+static void run_keymap_macros(void) {
+    run_macros(&macro_state);
+}
+
+#ifdef RAW_ENABLE
+static void run_telemetry_sender(void) {
+    // ホストのポーリングを待つ間はスティックの読み取りではなくこのタスクの時間になる
+    send_telemetry(&telemetry);
+}
+#endif
+
+static void run_oled(void);
+
+// Tasks of housekeeping_task_user(), the latency-critical ones first (the index is the one of ion_hid.py tasks)
+// TASK(function, period (ms), budget (us), background)
+// The budgets are not measured on the board yet: set them from the max_time of ion_hid.py tasks
+static struct TASK tasks[] = {
+    // The profile of a new layer is applied before the stick is reported with it
+    TASK(run_profile_swap, 0, TASK_BUDGET_UNMEASURED, false),
+    // The stick is sampled and reported once per USB poll
+    TASK(run_stick_sampler, USB_POLLING_INTERVAL_MS, TASK_BUDGET_UNMEASURED, false),
+    TASK(run_stick_reporter, USB_POLLING_INTERVAL_MS, TASK_BUDGET_UNMEASURED, false),
+    TASK(run_rapid_fire, 1, TASK_BUDGET_UNMEASURED, false),
+    TASK(run_keymap_macros, 0, TASK_BUDGET_UNMEASURED, false),
+    // The pages have their own periods (OLED_PAGE_*_PERIOD), a frame is cut at OLED_FRAME_BUDGET
+    TASK(run_oled, 0, TASK_BUDGET_UNMEASURED, true),
+    #ifdef RAW_ENABLE
+    // Sending a telemetry batch waits for the host to poll the raw HID endpoint (up to a poll interval)
+    TASK(run_telemetry_sender, 0, TASK_BUDGET_UNMEASURED, true),
+    #endif
+};
+
+void keyboard_post_init_user(void) {
+    load_settings(&settings);
+    apply_settings(&settings, &js_state, &js_rapid_state, &oled_page, layer_cache.layer);
+    init_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
+void housekeeping_task_user(void) {
+    run_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
+#ifdef RAW_ENABLE
+void raw_hid_receive(uint8_t *data, uint8_t length) {
+    switch (data[0]) {
+        case RAWHID_GET_VERSION:
+            data[1] = RAWHID_VERSION;
+            break;
+        case RAWHID_GET_STATS:
+            dump_scan_stats(&scan_stats, data[1], &data[2], length - 2);
+            break;
+        case RAWHID_TELEMETRY:
+            set_telemetry(&telemetry, data[1]);
+            break;
+        case RAWHID_SETTINGS_GET:
+        case RAWHID_SETTINGS_SET:
+        case RAWHID_SETTINGS_SAVE:
+        case RAWHID_SETTINGS_RESET:
+            if (process_settings_command(&settings, data)) {
+                apply_settings(&settings, &js_state, &js_rapid_state, &oled_page, layer_cache.layer);
+            }
+            break;
+        case RAWHID_GET_TASK:
+            dump_task(tasks, ARRAY_SIZE(tasks), data[1], &data[2], length - 2);
+            break;
+        default:
+            data[0] = RAWHID_ERROR;
+            break;
+    }
+    raw_hid_send(data, length);
+}
+#endif
+
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
     JOYSTICK_AXIS_VIRTUAL,
     JOYSTICK_AXIS_VIRTUAL,
 };
 
 void render_layer(void) {
+    // レイヤーが変わったか、画面を消したときだけ描き直す
+    bool is_changed = is_layer_changed(&layer_cache, &rendered_layer_seq);
+    if (!is_changed && !oled_page.is_cleared) return;
     // Maximum number of the length of the layer name is 14
-    switch (get_highest_layer(layer_state)) {
+    switch (layer_cache.layer) {
         case MAIN:
             render_layer_name(PSTR("MAIN"));
             #ifdef RGBLIGHT_ENABLE
@@ -114,19 +335,68 @@ void render_layer(void) {
     }
 };
 
-bool oled_task_user(void) {
-    if (!is_oled_enabled) return false;
-    render_logo();
-    oled_set_cursor(13, 0);
-    render_lock_state();
-    oled_set_cursor(13, 1);
-    render_js_state(&js_state, &js_rapid_state, is_joystick_mouse);
-    oled_set_cursor(0, 2);
-    render_layer();
+// Units of the status page, drawn one by one within OLED_FRAME_BUDGET (lib_ion/oled.h)
+enum STATUS_STEP {
+    STATUS_STEP_LOGO,
+    STATUS_STEP_LOCKS,
+    STATUS_STEP_JS,
+    STATUS_STEP_LAYER,
     #ifdef JS_DEBUG_ENABLED
-    oled_set_cursor(0, 3);
-    render_joystick_angles(&js_state);
+    STATUS_STEP_WIDGET,
     #endif
+    STATUS_STEPS,
+};
+
+void render_status_page(uint8_t step) {
+    switch (step) {
+        case STATUS_STEP_LOGO:
+            render_logo();
+            break;
+        case STATUS_STEP_LOCKS:
+            oled_set_cursor(13, 0);
+            render_lock_state();
+            break;
+        case STATUS_STEP_JS:
+            oled_set_cursor(13, 1);
+            render_js_state(&js_state, &js_rapid_state, is_stick_mouse());
+            break;
+        case STATUS_STEP_LAYER:
+            oled_set_cursor(0, 2);
+            render_layer();
+            break;
+        #ifdef JS_DEBUG_ENABLED
+        case STATUS_STEP_WIDGET:
+            if (oled_page.is_cleared) js_widget.drawn = false;
+            render_joystick_widget(&js_widget, &js_state);
+            break;
+        #endif
+    }
+};
+
+static void run_oled(void) {
+    if (!is_oled_enabled) return;
+    // 表示中のページだけを、ページごとの更新間隔で描画する
+    if (!start_oled_page(&oled_page)) return;
+    uint8_t step;
+    switch (oled_page.page) {
+        case OLED_PAGE_STATUS:
+            // 予算の分だけ描いて、残りは次の呼び出しで描く
+            while ((step = next_oled_step(&oled_page, STATUS_STEPS)) != OLED_STEP_NONE) render_status_page(step);
+            break;
+        case OLED_PAGE_STATS:
+            while ((step = next_oled_step(&oled_page, STATS_PAGE_STEPS)) != OLED_STEP_NONE) render_stats_page(&scan_stats, step);
+            break;
+        case OLED_PAGE_CALIBRATION:
+            render_calibration_page(&js_state, oled_page.is_cleared);
+            break;
+        case OLED_PAGE_RAPID:
+            render_rapid_page(&js_rapid_state);
+            break;
+    }
+}
+
+bool oled_task_user(void) {
+    // 描画は run_oled() のタスクで行い、QMK はバッファの変わった部分を送るだけにする
     return false;
 };
 
@@ -151,7 +421,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
      * `------------------------------------------------'  
      */
     [MAIN] = LAYOUT( \
-        JS_MO_TOGGLE, OLED_TOGGLE, MS_WHLU, LSA(KC_F9), JS_TOGGLE, \
+        JS_MO_TOGGLE, OLED_PAGE,   MS_WHLU, LSA(KC_F9), JS_TOGGLE, \
         MS_BTN5,      MS_BTN2,     MS_BTN3, MS_BTN1,    JS_RAPID, \
         MS_BTN4,      MS_WHLL,     MS_WHLD, MS_WHLR,    KC_F13, \
         KC_MUTE,      KC_MPRV,     KC_MNXT, KC_DOT,     LALT(KC_MPLY), OLED_TOGGLE, TO(NUMPADS) \
@@ -184,15 +454,15 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
      * |------+------+------+------+------|   
      * |RGBMOD|RGBRST|RGBVAI|RGBVAD|      |   
      * |------+------+------+------+------|   
-     * |      |      |      |      |      |   
+     * | JS2  | JS3  | JS4  | JS5  |HatStk|   
      * |------+------+------+------+------+------+------.  
-     * |      |      |      |      |      |JsPush|MAIN3  |  
+     * |HatLft|HatUp |HatDwn|HatRgt| JS1  |JsPush|MAIN3  |  
      * `------------------------------------------------'  
      */
     [TEST] = LAYOUT( \
         UG_TOGG, UG_HUEU, UG_HUED, UG_SATU, UG_SATD, \
         UG_NEXT, RGBRST,  UG_VALU, UG_VALD, XXXXXXX, \
-        XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, \
-        XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, JS_0, TO(MAIN) \
+        JS_2,     JS_3,   JS_4,     JS_5,      JS_HAT_STICK, \
+        HAT_LEFT, HAT_UP, HAT_DOWN, HAT_RIGHT, JS_1,         JS_0, TO(MAIN) \
     ),
 };
@@ -0,0 +1,14 @@
+# Raw HID: stats, tasks, settings and stick telemetry for lib_ion/tools/ion_hid.py
+# Opt-in (RAW_ENABLE = yes): the size of the 32u4 build with it is not measured yet
+RAW_ENABLE ?= no
+ifeq ($(strip $(RAW_ENABLE)), yes)
+    SRC += lib_ion/telemetry.c
+endif
+# Runtime settings (saved in the EEPROM block of EECONFIG_USER_DATA_SIZE in config.h)
+SRC += lib_ion/settings.c
+# Gamepad report with a hat switch and 16 buttons (lib_ion/gamepad.c), sent once per USB poll
+GAMEPAD_REPORT ?= yes
+ifeq ($(strip $(GAMEPAD_REPORT)), yes)
+    SRC += lib_ion/gamepad.c
+    OPT_DEFS += -DGAMEPAD_REPORT
+endif
@@ -19,3 +19,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #pragma once
+
+// Stick calibration measured with this keymap (instead of the board default in lhp14lite_d/config.h)
+#undef JS_X_LOW
+#undef JS_X_MID
+#undef JS_X_HIGH
+#undef JS_Y_LOW
+#undef JS_Y_MID
+#undef JS_Y_HIGH
+#define JS_X_LOW 782
+#define JS_X_MID 479
+#define JS_X_HIGH 150
+#define JS_Y_LOW 200
+#define JS_Y_MID 598
+#define JS_Y_HIGH 989
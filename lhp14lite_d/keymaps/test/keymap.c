@@ -4,19 +4,7 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
-
-// ADC Measured value
-#define min_x 150
-#define med_x 479
-#define max_x 782
-
-#define min_y 200
-#define med_y 598
-#define max_y 989
-
-#define adc_x F5
-#define adc_y F4
-
+#include "lib_ion/joystick.h"
 
 #define TST 0
 #define RGB 1
@@ -44,11 +32,19 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
   return true;
 };
 
+// Stick: pins and calibration in the config.h of the board (lib_ion/joystick.h)
+static struct JOYSTICK_STATE js_state = JS_INIT;
+
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
-    [0] = JOYSTICK_AXIS_IN(adc_x, max_x, med_x, min_x),
-    [1] = JOYSTICK_AXIS_IN(adc_y, min_y, med_y, max_y),
+    [0] = JOYSTICK_AXIS_VIRTUAL,
+    [1] = JOYSTICK_AXIS_VIRTUAL,
 };
 
+void matrix_scan_user(void) {
+    read_joystick_angles(&js_state);
+    report_joystick(&js_state, 0, 1);
+}
+
 
 
 void render_layer(void) {
@@ -56,8 +52,8 @@ void render_layer(void) {
     char val_str[20];
     
     oled_set_cursor(0, 0);
-    uint16_t val = analogReadPin(adc_x);
-    static uint16_t min_xx = 1023;
+    uint16_t val = analogReadPin(JS_PIN_X);
+    static uint16_t min_xx = JS_ADC_MAX;
     static uint16_t max_xx = 0;
       
       if (val > max_xx) {
@@ -78,8 +74,8 @@ void render_layer(void) {
     
     
     oled_set_cursor(0, 1);
-    val = analogReadPin(adc_y);
-    static uint16_t min_yy = 1023;
+    val = analogReadPin(JS_PIN_Y);
+    static uint16_t min_yy = JS_ADC_MAX;
     static uint16_t max_yy = 0;
       
       if (val > max_yy) {
@@ -7,7 +7,15 @@
 #define LOGO_LINES 2
 #define LOGO_COLUMNS 13
 
+#if defined(OLED_LOGO_BITMAP)
+// Generated by rules.mk from logo.pbm: drawn by render_logo() in lib_ion/oled.c
+#include "logo_bitmap.h"
+#elif defined(OLED_FONT_SUBSET)
+// The glyphs are renumbered for the subset font
+static const char PROGMEM lhp_logo[LOGO_LINES][LOGO_COLUMNS + 1] = LHP_LOGO_SUBSET;
+#else
 static const char PROGMEM lhp_logo[LOGO_LINES][LOGO_COLUMNS + 1] = {
     { 0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x8B, 0x8C, 0x00 },
     { 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0x00 }
 };
+#endif
@@ -19,3 +19,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #pragma once
+
+// Stick calibration measured with this keymap at 10 bits (instead of the board default in lhp14lite_rp2040d/config.h)
+#undef JS_X_LOW
+#undef JS_X_MID
+#undef JS_X_HIGH
+#undef JS_Y_LOW
+#undef JS_Y_MID
+#undef JS_Y_HIGH
+#define JS_X_LOW JS_ADC_10BIT(521)
+#define JS_X_MID JS_ADC_10BIT(329)
+#define JS_X_HIGH JS_ADC_10BIT(138)
+#define JS_Y_LOW JS_ADC_10BIT(127)
+#define JS_Y_MID JS_ADC_10BIT(339)
+#define JS_Y_HIGH JS_ADC_10BIT(549)
@@ -4,15 +4,11 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
-
-// ADC Measured value
-#define min_x 139
-#define med_x 329
-#define max_x 521
-
-#define min_y 139
-#define med_y 339
-#define max_y 543
+#include "lib_ion/joystick.h"
+#include "lib_ion/scheduler.h"
+#include "lib_ion/keymap_sparse.h"
+#include "lib_ion/layer.h"
+#include "lib_ion/selector.h"
 
 // Layer(=job) MAX 32jobs available
 #define DRK 0
@@ -58,12 +54,55 @@ void render_logo(void) {
     oled_write_P(lhp_logo, false);
 };
 
+static struct LAYER_CACHE layer_cache = LAYER_CACHE_INIT;
+static uint8_t rendered_layer_seq = 0;
+
+// Job names shown on the OLED and in the job selector (hold JS_0 and tilt the stick)
+static const char PROGMEM job_names[][LAYER_NAME_SIZE] = {
+    [DRK] = "DARK KNIGHT",
+    [GNB] = "GUNBREAKER",
+    [WAR] = "WARRIOR",
+    [PLD] = "PALADIN",
+    [DRG] = "DRAGOON",
+    [SAM] = "SAMURAI",
+    [MNK] = "MONK",
+    [RPR] = "REAPER",
+    [NIN] = "NINJA",
+    [BRD] = "BARD",
+    [MCH] = "MACHINIST",
+    [DNC] = "DANCER",
+    [RDM] = "RED MAGE",
+    [SMN] = "SUMMONER",
+    [BLM] = "BLACK MAGE",
+    [BLU] = "BLUE MAGE",
+    [WHM] = "WHITE MAGE",
+    [SCH] = "SCHOLAR",
+    [AST] = "ASTROLOGIAN",
+    [SGE] = "SAGE",
+    [GAT] = "GATHERER",
+    [CRA] = "CRAFTER",
+    [GLA] = "GLADIATOR",
+    [MRD] = "MARAUDER",
+    [LNC] = "LANCER",
+    [PUG] = "PUGILIST",
+    [ROG] = "ROGUE",
+    [ARC] = "ARCHER",
+    [THM] = "THAUMATURGE",
+    [ACN] = "ARCANIST",
+    [CNJ] = "CONJURER",
+    [RGB] = "RGB LED TEST",
+};
+static struct LAYER_SELECTOR_STATE job_selector = LAYER_SELECTOR_INIT(ARRAY_SIZE(job_names));
+
 enum custom_keycodes {
   RGBRST = SAFE_RANGE,
 };
 
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
   switch (keycode) {
+    case JS_0:
+      press_layer_selector(&job_selector, record->event.pressed, layer_cache.layer);
+      break;
     case RGBRST:
       #ifdef RGBLIGHT_ENABLE
         if (record->event.pressed) {
@@ -78,182 +117,187 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 
 
 
+// Stick: pins and calibration in the config.h of the board (lib_ion/joystick.h)
+static struct JOYSTICK_STATE js_state = JS_INIT;
+
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
-    [0] = JOYSTICK_AXIS_IN(GP28, max_x, med_x, min_x),
-    [1] = JOYSTICK_AXIS_IN(GP29, min_y, med_y, max_y),
+    [0] = JOYSTICK_AXIS_VIRTUAL,
+    [1] = JOYSTICK_AXIS_VIRTUAL,
 };
 
+static void run_stick(void) {
+    read_joystick_angles(&js_state);
+    report_joystick(&js_state, 0, 1);
+    run_layer_selector(&job_selector, js_state.y);
+}
+
+// Tasks of housekeeping_task_user() (lib_ion/scheduler.h)
+// TASK(function, period (ms), budget (us), background)
+static struct TASK tasks[] = {
+    // The stick is read and reported once per USB poll instead of once per matrix scan
+    TASK(run_stick, USB_POLLING_INTERVAL_MS, TASK_BUDGET_UNMEASURED, false),
+};
 
+void keyboard_post_init_user(void) {
+    init_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
+void housekeeping_task_user(void) {
+    run_tasks(tasks, ARRAY_SIZE(tasks));
+}
+
+
+
+layer_state_t layer_state_set_user(layer_state_t state) {
+    return update_layer_cache(&layer_cache, state);
+}
 
 void render_layer(void) {	
+    // Only when the layer is changed: the name and the color stay until the next change
+    if (!is_layer_changed(&layer_cache, &rendered_layer_seq)) return;
     oled_set_cursor(0, 3);
     // Host Keyboard Layer Status
     oled_write_P(PSTR("Layer: "), false);
+    if (layer_cache.layer < ARRAY_SIZE(job_names)) {
+        oled_write_ln_P(job_names[layer_cache.layer], false);
+    } else {
+        oled_write_ln_P(PSTR("Undefined"), false);
+    }
 
-    switch (get_highest_layer(layer_state)) {
-
+    switch (layer_cache.layer) {
         case DRK:
-            oled_write_P(PSTR("DARK KNIGHT\n"), false);
             rgblight_sethsv(0, 255, 90);
             break;
-            
+
         case GNB:
-            oled_write_P(PSTR("GUNBREAKER\n"), false);
             rgblight_sethsv(0, 0, 100);
             break;
-            
+
         case WAR:
-            oled_write_P(PSTR("WARRIOR\n"), false);
             rgblight_sethsv(85, 255, 90);
             break;
-            
+
         case PLD:
-            oled_write_P(PSTR("PALADIN\n"), false);
             rgblight_sethsv(127, 170, 100);
             break;
-            
+
         case DRG:
-            oled_write_P(PSTR("DRAGOON\n"), false);
             rgblight_sethsv(170, 255, 180);
             break;
-            
+
         case SAM:
-            oled_write_P(PSTR("SAMURAI\n"), false);
             rgblight_sethsv(0, 255, 180);
             break;
-            
+
         case MNK:
-            oled_write_P(PSTR("MONK\n"), false);
             rgblight_sethsv(85, 255, 50);
             break;
-            
+
         case RPR:
-            oled_write_P(PSTR("REAPER\n"), false);
             rgblight_sethsv(0, 255, 20);
             break;
-            
+
         case NIN:
-            oled_write_P(PSTR("NINJA\n"), false);
             rgblight_sethsv(191, 255, 150);
             break;
-            
+
         case BRD:
-            oled_write_P(PSTR("BARD\n"), false);
             rgblight_sethsv(91, 199, 140);
             break;
-            
+
         case MCH:
-            oled_write_P(PSTR("MACHINIST\n"), false);
             rgblight_sethsv(68, 15, 150);
             break;
-            
+
         case DNC:
-            oled_write_P(PSTR("DANCER\n"), false);
             rgblight_sethsv(213, 255, 180);
             break;
-            
+
         case RDM:
-            oled_write_P(PSTR("RED MAGE\n"), false);
             rgblight_sethsv(0, 255, 220);
             break;
-            
+
         case SMN:
-            oled_write_P(PSTR("SUMMONER\n"), false);
             rgblight_sethsv(20, 255, 100);
             break;
-            
+
         case BLM:
-            oled_write_P(PSTR("BLACK MAGE\n"), false);
             rgblight_sethsv(68, 15, 50);
             break;
-            
+
         case BLU:
-            oled_write_P(PSTR("BLUE MAGE\n"), false);
             rgblight_sethsv(170, 255, 200);
             break;
-            
+
         case WHM:
-            oled_write_P(PSTR("WHITE MAGE\n"), false);
             rgblight_sethsv(11, 176, 180);
             break;
-            
+
         case SCH:
-            oled_write_P(PSTR("SCHOLAR\n"), false);
             rgblight_sethsv(20, 255, 210);
             break;
-            
+
         case AST:
-            oled_write_P(PSTR("ASTROLOGIAN\n"), false);
             rgblight_sethsv(127, 255, 180);
             break;
 
         case SGE:
-            oled_write_P(PSTR("SAGE\n"), false);
             rgblight_sethsv(100, 100, 90);
             break;
-            
+
         case GAT:
-            oled_write_P(PSTR("GATHERER\n"), false);
             rgblight_sethsv(68, 130, 190);
             break;
-            
+
         case CRA:
-            oled_write_P(PSTR("CRAFTER\n"), false);
             rgblight_sethsv(198, 130, 190);
             break;
-            
+
         case GLA:
-            oled_write_P(PSTR("GLADIATOR\n"), false);
             rgblight_sethsv(127, 170, 80);
             break;
-            
+
         case MRD:
-            oled_write_P(PSTR("MARAUDER\n"), false);
             rgblight_sethsv(85, 255, 70);
             break;
+
         case LNC:
-            oled_write_P(PSTR("LANCER\n"), false);
             rgblight_sethsv(170, 255, 160);
             break;
-            
+
         case PUG:
-            oled_write_P(PSTR("PUGILIST\n"), false);
             rgblight_sethsv(85, 255, 30);
             break;
+
         case ROG:
-            oled_write_P(PSTR("ROGUE\n"), false);
             rgblight_sethsv(190, 255, 130);
             break;
-            
+
         case ARC:
-            oled_write_P(PSTR("ARCHER\n"), false);
             rgblight_sethsv(90, 200, 120);
             break;
+
         case THM:
-            oled_write_P(PSTR("THAUMATURGE\n"), false);
             rgblight_sethsv(68, 15, 30);
             break;
-            
+
         case ACN:
-            oled_write_P(PSTR("ARCANIST\n"), false);
             rgblight_sethsv(20, 255, 80);
             break;
+
         case CNJ:
-            oled_write_P(PSTR("CONJURER\n"), false);
             rgblight_sethsv(10, 176, 160);
             break;
-            
-        case RGB:
-            oled_write_P(PSTR("RGB LED TEST\n"), false);
-            break;
-            
-        default:
-            // Or use the write_ln shortcut over adding '\n' to the end of your string
-            oled_write_ln_P(PSTR("Undefined"), false);
     }
 };
 
 bool oled_task_user(void) {
+    if (job_selector.active) {
+        render_layer_selector(&job_selector, job_names);
+        // Draw the layer again after the selector is closed
+        rendered_layer_seq = 0;
+        return false;
+    }
     render_logo();
     render_layer();
     return false;
@@ -289,7 +333,9 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
     XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
     XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(GNB) \
   ),
+};
 
+// Job layers after DRK: only the keys different from DRK (see lib_ion/keymap_sparse.h)
 
   /* GNB
    * ,----------------------------------.   
@@ -302,13 +348,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|WAR   |  
    * `------------------------------------------------'  
    */
-  [GNB] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(WAR) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM gnb_keys[] = {SK(3, 6, TO(WAR))};
 
   /* WAR
    * ,----------------------------------.   
@@ -321,13 +361,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|PLD   |  
    * `------------------------------------------------'  
    */
-  [WAR] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(PLD) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM war_keys[] = {SK(3, 6, TO(PLD))};
 
   /* PLD
    * ,----------------------------------.   
@@ -340,13 +374,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|DRG   |  
    * `------------------------------------------------'  
    */
-  [PLD] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(DRG) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM pld_keys[] = {SK(3, 6, TO(DRG))};
 
   /* DRG
    * ,----------------------------------.   
@@ -359,13 +387,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|SAM   |  
    * `------------------------------------------------'  
    */
-  [DRG] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(SAM) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM drg_keys[] = {SK(3, 6, TO(SAM))};
 
   /* SAM
    * ,----------------------------------.   
@@ -378,13 +400,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|MNK   |  
    * `------------------------------------------------'  
    */
-  [SAM] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(MNK) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM sam_keys[] = {SK(3, 6, TO(MNK))};
 
   /* MNK
    * ,----------------------------------.   
@@ -397,13 +413,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|NIN   |  
    * `------------------------------------------------'  
    */
-  [MNK] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(NIN) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM mnk_keys[] = {SK(3, 6, TO(NIN))};
 
   /* NIN
    * ,----------------------------------.   
@@ -416,13 +426,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|RPR   |  
    * `------------------------------------------------'  
    */
-  [NIN] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(RPR) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM nin_keys[] = {SK(3, 6, TO(RPR))};
 
   /* RPR
    * ,----------------------------------.   
@@ -435,13 +439,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|BRD   |  
    * `------------------------------------------------'  
    */
-  [RPR] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(BRD) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM rpr_keys[] = {SK(3, 6, TO(BRD))};
 
   /* BRD
    * ,----------------------------------.   
@@ -454,13 +452,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|MCH   |  
    * `------------------------------------------------'  
    */
-  [BRD] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(MCH) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM brd_keys[] = {SK(3, 6, TO(MCH))};
 
   /* MCH
    * ,----------------------------------.   
@@ -473,13 +465,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|DNC   |  
    * `------------------------------------------------'  
    */
-  [MCH] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(DNC) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM mch_keys[] = {SK(3, 6, TO(DNC))};
 
   /* DNC
    * ,----------------------------------.   
@@ -492,13 +478,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|RDM   |  
    * `------------------------------------------------'  
    */
-  [DNC] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(RDM) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM dnc_keys[] = {SK(3, 6, TO(RDM))};
 
   /* RDM
    * ,----------------------------------.   
@@ -511,13 +491,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|SMN   |  
    * `------------------------------------------------'  
    */
-  [RDM] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(SMN) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM rdm_keys[] = {SK(3, 6, TO(SMN))};
 
   /* SMN
    * ,----------------------------------.   
@@ -530,13 +504,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|BLM   |  
    * `------------------------------------------------'  
    */
-  [SMN] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(BLM) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM smn_keys[] = {SK(3, 6, TO(BLM))};
 
   /* BLM
    * ,----------------------------------.   
@@ -549,13 +517,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|BLU   |  
    * `------------------------------------------------'  
    */
-  [BLM] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(BLU) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM blm_keys[] = {SK(3, 6, TO(BLU))};
 
   /* BLU
    * ,----------------------------------.   
@@ -568,13 +530,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|WHM   |  
    * `------------------------------------------------'  
    */
-  [BLU] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(WHM) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM blu_keys[] = {SK(3, 6, TO(WHM))};
 
   /* WHM
    * ,----------------------------------.   
@@ -587,13 +543,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|SCH   |  
    * `------------------------------------------------'  
    */
-  [WHM] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(SCH) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM whm_keys[] = {SK(3, 6, TO(SCH))};
 
   /* SCH
    * ,----------------------------------.   
@@ -606,13 +556,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|AST   |  
    * `------------------------------------------------'  
    */
-  [SCH] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(AST) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM sch_keys[] = {SK(3, 6, TO(AST))};
 
   /* AST
    * ,----------------------------------.   
@@ -625,13 +569,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|SGE   |  
    * `------------------------------------------------'  
    */
-  [AST] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(SGE) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM ast_keys[] = {SK(3, 6, TO(SGE))};
 
   /* SGE
    * ,----------------------------------.   
@@ -644,13 +582,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|GAT   |  
    * `------------------------------------------------'  
    */
-  [SGE] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(GAT) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM sge_keys[] = {SK(3, 6, TO(GAT))};
 
   /* GAT
    * ,----------------------------------.   
@@ -663,13 +595,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|CRA   |  
    * `------------------------------------------------'  
    */
-  [GAT] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(CRA) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM gat_keys[] = {SK(3, 6, TO(CRA))};
 
   /* CRA
    * ,----------------------------------.   
@@ -682,13 +608,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|GLA   |  
    * `------------------------------------------------'  
    */
-  [CRA] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(GLA) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM cra_keys[] = {SK(3, 6, TO(GLA))};
 
   /* GLA
    * ,----------------------------------.   
@@ -701,13 +621,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|MRD   |  
    * `------------------------------------------------'  
    */
-  [GLA] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(MRD) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM gla_keys[] = {SK(3, 6, TO(MRD))};
 
   /* MRD
    * ,----------------------------------.   
@@ -720,13 +634,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|LNC   |  
    * `------------------------------------------------'  
    */
-  [MRD] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(LNC) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM mrd_keys[] = {SK(3, 6, TO(LNC))};
 
   /* LNC
    * ,----------------------------------.   
@@ -739,13 +647,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|PUG   |  
    * `------------------------------------------------'  
    */
-  [LNC] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(PUG) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM lnc_keys[] = {SK(3, 6, TO(PUG))};
 
   /* PUG
    * ,----------------------------------.   
@@ -758,13 +660,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|ROG   |  
    * `------------------------------------------------'  
    */
-  [PUG] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(ROG) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM pug_keys[] = {SK(3, 6, TO(ROG))};
 
   /* ROG
    * ,----------------------------------.   
@@ -777,13 +673,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|ARC   |  
    * `------------------------------------------------'  
    */
-  [ROG] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(ARC) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM rog_keys[] = {SK(3, 6, TO(ARC))};
 
   /* ARC
    * ,----------------------------------.   
@@ -796,13 +686,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|THM   |  
    * `------------------------------------------------'  
    */
-  [ARC] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(THM) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM arc_keys[] = {SK(3, 6, TO(THM))};
 
   /* THM
    * ,----------------------------------.   
@@ -815,13 +699,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|ACN   |  
    * `------------------------------------------------'  
    */
-  [THM] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(ACN) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM thm_keys[] = {SK(3, 6, TO(ACN))};
 
   /* ACN
    * ,----------------------------------.   
@@ -834,13 +712,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|CNJ   |  
    * `------------------------------------------------'  
    */
-  [ACN] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(CNJ) \
-  ),
-
+static const struct SPARSE_KEY PROGMEM acn_keys[] = {SK(3, 6, TO(CNJ))};
 
   /* CNJ
    * ,----------------------------------.   
@@ -853,14 +725,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|RGB   |  
    * `------------------------------------------------'  
    */
-  [CNJ] = LAYOUT( \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(RGB) \
-  ),
-
-
+static const struct SPARSE_KEY PROGMEM cnj_keys[] = {SK(3, 6, TO(RGB))};
 
   /* RGB
    * ,----------------------------------.   
@@ -873,14 +738,51 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
    * |      |      |      |      |      |JsPush|DRK   |  
    * `------------------------------------------------'  
    */
-  [RGB] = LAYOUT( \
-    UG_TOGG,   UG_HUEU,   UG_HUED,    UG_SATU,    UG_SATD, \
-    UG_NEXT,   RGBRST,    UG_VALU,    UG_VALD,    XXXXXXX, \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,    XXXXXXX,    XXXXXXX, \
-    XXXXXXX,   XXXXXXX,   XXXXXXX,    XXXXXXX,    XXXXXXX, JS_0, TO(DRK) \
-  ),
+static const struct SPARSE_KEY PROGMEM rgb_keys[] = {
+    SK(0, 0, UG_TOGG), SK(0, 1, UG_HUEU), SK(0, 2, UG_HUED), SK(0, 3, UG_SATU), SK(0, 4, UG_SATD),
+    SK(1, 0, UG_NEXT), SK(1, 1, RGBRST), SK(1, 2, UG_VALU), SK(1, 3, UG_VALD), SK(3, 6, TO(DRK))
+};
 
+#define SPARSE_FIRST GNB
+static const struct SPARSE_LAYER PROGMEM sparse_layers[] = {
+  [GNB - SPARSE_FIRST] = SPARSE_LAYER(DRK, gnb_keys),
+  [WAR - SPARSE_FIRST] = SPARSE_LAYER(DRK, war_keys),
+  [PLD - SPARSE_FIRST] = SPARSE_LAYER(DRK, pld_keys),
+  [DRG - SPARSE_FIRST] = SPARSE_LAYER(DRK, drg_keys),
+  [SAM - SPARSE_FIRST] = SPARSE_LAYER(DRK, sam_keys),
+  [MNK - SPARSE_FIRST] = SPARSE_LAYER(DRK, mnk_keys),
+  [NIN - SPARSE_FIRST] = SPARSE_LAYER(DRK, nin_keys),
+  [RPR - SPARSE_FIRST] = SPARSE_LAYER(DRK, rpr_keys),
+  [BRD - SPARSE_FIRST] = SPARSE_LAYER(DRK, brd_keys),
+  [MCH - SPARSE_FIRST] = SPARSE_LAYER(DRK, mch_keys),
+  [DNC - SPARSE_FIRST] = SPARSE_LAYER(DRK, dnc_keys),
+  [RDM - SPARSE_FIRST] = SPARSE_LAYER(DRK, rdm_keys),
+  [SMN - SPARSE_FIRST] = SPARSE_LAYER(DRK, smn_keys),
+  [BLM - SPARSE_FIRST] = SPARSE_LAYER(DRK, blm_keys),
+  [BLU - SPARSE_FIRST] = SPARSE_LAYER(DRK, blu_keys),
+  [WHM - SPARSE_FIRST] = SPARSE_LAYER(DRK, whm_keys),
+  [SCH - SPARSE_FIRST] = SPARSE_LAYER(DRK, sch_keys),
+  [AST - SPARSE_FIRST] = SPARSE_LAYER(DRK, ast_keys),
+  [SGE - SPARSE_FIRST] = SPARSE_LAYER(DRK, sge_keys),
+  [GAT - SPARSE_FIRST] = SPARSE_LAYER(DRK, gat_keys),
+  [CRA - SPARSE_FIRST] = SPARSE_LAYER(DRK, cra_keys),
+  [GLA - SPARSE_FIRST] = SPARSE_LAYER(DRK, gla_keys),
+  [MRD - SPARSE_FIRST] = SPARSE_LAYER(DRK, mrd_keys),
+  [LNC - SPARSE_FIRST] = SPARSE_LAYER(DRK, lnc_keys),
+  [PUG - SPARSE_FIRST] = SPARSE_LAYER(DRK, pug_keys),
+  [ROG - SPARSE_FIRST] = SPARSE_LAYER(DRK, rog_keys),
+  [ARC - SPARSE_FIRST] = SPARSE_LAYER(DRK, arc_keys),
+  [THM - SPARSE_FIRST] = SPARSE_LAYER(DRK, thm_keys),
+  [ACN - SPARSE_FIRST] = SPARSE_LAYER(DRK, acn_keys),
+  [CNJ - SPARSE_FIRST] = SPARSE_LAYER(DRK, cnj_keys),
+  [RGB - SPARSE_FIRST] = SPARSE_LAYER(DRK, rgb_keys),
 };
+static struct SPARSE_CACHE sparse_cache = SPARSE_CACHE_INIT;
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    return sparse_keycode(&sparse_cache, layer, key.row, key.col, SPARSE_FIRST, sparse_layers, ARRAY_SIZE(sparse_layers));
+}
+
 
 
 
@@ -0,0 +1 @@
+SRC += lib_ion/keymap_sparse.c lib_ion/layer.c lib_ion/selector.c
@@ -19,3 +19,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #pragma once
+
+// Time the stick mapping with and without the XIP cache (lib_ion/joystick.h), shown on the OLED
+#define JS_BENCHMARK 100
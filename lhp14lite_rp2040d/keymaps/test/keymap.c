@@ -4,16 +4,7 @@
 #include QMK_KEYBOARD_H
 #include "joystick.h"
 #include "analog.h"
-
-// ADC Measured value
-#define min_x 139
-#define med_x 329
-#define max_x 521
-
-#define min_y 139
-#define med_y 339
-#define max_y 543
-
+#include "lib_ion/joystick.h"
 
 #define TST 0
 #define RGB 1
@@ -42,11 +33,19 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 };
 
 
+// Stick: pins and calibration in the config.h of the board (lib_ion/joystick.h)
+static struct JOYSTICK_STATE js_state = JS_INIT;
+
 joystick_config_t joystick_axes[JOYSTICK_AXIS_COUNT] = {
-    [0] = JOYSTICK_AXIS_IN(GP28, max_x, med_x, min_x),
-    [1] = JOYSTICK_AXIS_IN(GP29, min_y, med_y, max_y),
+    [0] = JOYSTICK_AXIS_VIRTUAL,
+    [1] = JOYSTICK_AXIS_VIRTUAL,
 };
 
+void matrix_scan_user(void) {
+    read_joystick_angles(&js_state);
+    report_joystick(&js_state, 0, 1);
+}
+
 
 
 void render_layer(void) {
@@ -54,8 +53,8 @@ void render_layer(void) {
     char val_str[20];
     
     oled_set_cursor(0, 0);
-    uint16_t val = analogReadPin(GP28);
-    static uint16_t min_xx = 1023;
+    uint16_t val = analogReadPin(JS_PIN_X);
+    static uint16_t min_xx = JS_ADC_MAX;
     static uint16_t max_xx = 0;
       
       if (val > max_xx) {
@@ -76,8 +75,8 @@ void render_layer(void) {
     
     
     oled_set_cursor(0, 1);
-    val = analogReadPin(GP29);
-    static uint16_t min_yy = 1023;
+    val = analogReadPin(JS_PIN_Y);
+    static uint16_t min_yy = JS_ADC_MAX;
     static uint16_t max_yy = 0;
       
       if (val > max_yy) {
@@ -117,8 +116,29 @@ void render_layer(void) {
     }
 };
 
+#ifdef JS_BENCHMARK
+void render_joystick_benchmark(void) {
+    // スティックの処理1回の時間 (us): 直前に実行したとき / XIP のキャッシュを空にしたとき の最小-最大
+    // RAM_FUNCS = no でビルドすると、フラッシュから実行する場合と比べられる
+    // 計測は初めて表示したときに一度だけ
+    static struct JOYSTICK_BENCHMARK js_benchmark;
+    static bool is_measured = false;
+    if (!is_measured) {
+        run_joystick_benchmark(&js_benchmark, &js_state);
+        is_measured = true;
+    }
+    char val_str[22];
+    snprintf(val_str, sizeof(val_str), "Map:%u-%u Cold:%u-%u", js_benchmark.warm_min, js_benchmark.warm_max, js_benchmark.cold_min, js_benchmark.cold_max);
+    oled_set_cursor(0, 2);
+    oled_write(val_str, false);
+}
+#endif
+
 bool oled_task_user(void) {
     render_layer();
+    #ifdef JS_BENCHMARK
+    render_joystick_benchmark();
+    #endif
     return false;
 };
 
@@ -1,4 +1,24 @@
 JOYSTICK_ENABLE = yes
 JOYSTICK_DRIVER = analog
+# Mouse mode of the stick (lib_ion/joystick.h)
+POINTING_DEVICE_ENABLE = yes
+POINTING_DEVICE_DRIVER = custom
 
 
+SRC += lib_ion/joystick.c lib_ion/macro.c
+# Tasks of housekeeping_task_user() with periods and run time counters (lib_ion/scheduler.h)
+SRC += lib_ion/scheduler.c lib_ion/timer_us.c
+
+# Hot lib_ion code (stick, debounce, scheduler) runs from the SRAM instead of the XIP flash (see lib_ion/ram_func.h)
+# RAM_FUNCS = no leaves it in the flash
+RAM_FUNCS ?= yes
+ifeq ($(strip $(RAM_FUNCS)), yes)
+    OPT_DEFS += -DRAM_FUNCS
+endif
+
+# Debounce: send a press at once and a release after it is stable, per key (see lib_ion/eager_debounce.h)
+# DEBOUNCE_TYPE = sym_defer_g goes back to the QMK default
+DEBOUNCE_TYPE ?= custom
+ifeq ($(strip $(DEBOUNCE_TYPE)), custom)
+    SRC += lib_ion/eager_debounce.c
+endif
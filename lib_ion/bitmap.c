@@ -0,0 +1,32 @@
+// lib_ion/tools/bitmap.py で変換したビットマップを OLED のバッファに直接書き込む
+#include QMK_KEYBOARD_H
+#include "lib_ion/bitmap.h"
+
+void render_bitmap_P(const uint8_t *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages) {
+    uint16_t index = (uint16_t)page * OLED_DISPLAY_WIDTH + x;
+    uint16_t remaining = (uint16_t)width * pages;
+    uint8_t column = 0;
+    bool is_rle = pgm_read_byte(data++) == BITMAP_RLE;
+    while (remaining > 0) {
+        // RAW は全体を1つの並びとして書く
+        // RLE は 0x80 未満: 続く (n + 1) バイトをそのまま, 0x80 以上: 次の1バイトを (n - 0x80 + 2) 回繰り返す
+        bool is_repeat = false;
+        uint16_t count = remaining;
+        if (is_rle) {
+            uint8_t control = pgm_read_byte(data++);
+            is_repeat = control >= 0x80;
+            count = is_repeat ? control - 0x80 + 2 : control + 1;
+        }
+        for (; count > 0 && remaining > 0; count--, remaining--) {
+            oled_write_raw_byte(pgm_read_byte(data), index);
+            if (!is_repeat) data++;
+            if (++column < width) {
+                index++;
+            } else {
+                column = 0;
+                index += OLED_DISPLAY_WIDTH - width + 1;
+            }
+        }
+        if (is_repeat) data++;
+    }
+}
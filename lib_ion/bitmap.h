@@ -0,0 +1,10 @@
+#pragma once
+#include <stdint.h>
+
+// Bitmaps converted by lib_ion/tools/bitmap.py: pages of 8 pixel rows, one byte per column.
+// The first byte is the format; RLE is used only when it makes the bitmap smaller.
+#define BITMAP_RAW 0x00
+#define BITMAP_RLE 0x01
+
+// Writes a PROGMEM bitmap of width columns and pages pages into the OLED buffer at (x, page)
+void render_bitmap_P(const uint8_t *data, uint8_t x, uint8_t page, uint8_t width, uint8_t pages);
@@ -0,0 +1,92 @@
+// 押したときは待たずにすぐ送り、離したときは一定時間離れたままなのを確かめてから送るチャタリング対策 (キーごと)
+#include QMK_KEYBOARD_H
+#include "debounce.h"
+#include "lib_ion/eager_debounce.h"
+#include "lib_ion/ram_func.h"
+
+// キーごとの残り時間 (ms)。最上位ビットは離した状態の確認中を表す
+#define DEBOUNCE_PENDING 0x80
+#define DEBOUNCE_TIME_MASK 0x7F
+
+#if defined(DEBOUNCE_RELEASE_KEYS)
+static const uint8_t PROGMEM release_times[MATRIX_ROWS][MATRIX_COLS] = DEBOUNCE_RELEASE_KEYS;
+#    define RELEASE_TIME(row, col) pgm_read_byte(&release_times[row][col])
+#elif defined(DEBOUNCE_RELEASE_ROWS)
+static const uint8_t PROGMEM release_times[MATRIX_ROWS] = DEBOUNCE_RELEASE_ROWS;
+#    define RELEASE_TIME(row, col) pgm_read_byte(&release_times[row])
+#else
+#    define RELEASE_TIME(row, col) DEBOUNCE_RELEASE
+#endif
+
+static uint8_t debounce_timers[MATRIX_ROWS][MATRIX_COLS];
+static bool is_counting = false;
+static uint16_t last_time;
+
+void debounce_init(uint8_t num_rows) {
+    memset(debounce_timers, 0, sizeof(debounce_timers));
+    last_time = timer_read();
+}
+
+RAM_FUNC bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint16_t now = timer_read();
+    uint16_t elapsed = now - last_time;
+    last_time = now;
+    // 変化がなく、数えている時間もなければ何もしない (ほとんどのスキャン)
+    if (!changed && !is_counting) return false;
+    bool cooked_changed = false;
+    is_counting = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t raw_row = raw[row];
+        matrix_row_t cooked_row = cooked[row];
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            matrix_row_t bit = (matrix_row_t)1 << col;
+            bool is_raw = raw_row & bit;
+            bool is_cooked = cooked_row & bit;
+            uint8_t *timer = &debounce_timers[row][col];
+            if (*timer != 0) {
+                if (*timer & DEBOUNCE_PENDING) {
+                    // 確認中にまた押されたら、離したのはチャタリングだったとして取り消す
+                    if (is_raw) {
+                        *timer = 0;
+                        continue;
+                    }
+                    if ((*timer & DEBOUNCE_TIME_MASK) > elapsed) {
+                        *timer -= elapsed;
+                        is_counting = true;
+                        continue;
+                    }
+                    cooked_row &= ~bit;
+                    *timer = 0;
+                    continue;
+                }
+                // 押した直後のチャタリングは無視する
+                if (*timer > elapsed) {
+                    *timer -= elapsed;
+                    is_counting = true;
+                    continue;
+                }
+                *timer = 0;
+            }
+            if (is_raw == is_cooked) continue;
+            if (is_raw) {
+                cooked_row |= bit;
+                *timer = DEBOUNCE_PRESS_LOCK & DEBOUNCE_TIME_MASK;
+            } else {
+                uint8_t release = RELEASE_TIME(row, col) & DEBOUNCE_TIME_MASK;
+                if (release == 0) {
+                    cooked_row &= ~bit;
+                } else {
+                    *timer = DEBOUNCE_PENDING | release;
+                }
+            }
+            if (*timer != 0) is_counting = true;
+        }
+        if (cooked_row != cooked[row]) {
+            cooked[row] = cooked_row;
+            cooked_changed = true;
+        }
+    }
+    return cooked_changed;
+}
+
+void debounce_free(void) {}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Debounce (DEBOUNCE_TYPE = custom): a press is sent at once (eager) and a release is sent
+// after the key has been released for a while (deferred), separately for each key.
+// The times can be set in config.h; each time is 0 - 127 ms.
+
+// Changes ignored after a press is sent (bounces of the press)
+#ifndef DEBOUNCE_PRESS_LOCK
+#define DEBOUNCE_PRESS_LOCK DEBOUNCE
+#endif
+// Time the key has to stay released before the release is sent
+#ifndef DEBOUNCE_RELEASE
+#define DEBOUNCE_RELEASE DEBOUNCE
+#endif
+// Overrides of DEBOUNCE_RELEASE (define one of them in config.h):
+// DEBOUNCE_RELEASE_ROWS: { row 0, row 1, ... }
+// DEBOUNCE_RELEASE_KEYS: { { row 0 col 0, row 0 col 1, ... }, ... }
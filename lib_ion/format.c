@@ -0,0 +1,62 @@
+// OLED 表示用の固定幅の整数フォーマッタ
+// フラッシュメモリ節約のため sprintf を使わず、AVR で遅い除算も使わずに10の累乗の減算で桁を求める
+#include QMK_KEYBOARD_H
+#include "lib_ion/format.h"
+
+static const uint16_t PROGMEM powers_of_ten[FORMAT_WIDTH_MAX] = { 1, 10, 100, 1000, 10000 };
+static const char PROGMEM hex_digits[16] = "0123456789ABCDEF";
+
+static void fill_overflow(char *buf, uint8_t width) {
+    for (uint8_t i = 0; i < width; i++) buf[i] = '#';
+    buf[width] = '\0';
+}
+
+// val を右詰めで書き込み、先頭を空白で埋める。符号は数字の直前に置く
+static void format_decimal(char *buf, uint16_t val, uint8_t width, bool is_negative) {
+    uint8_t pos = 0;
+    bool is_nonzero_printed = false;
+    // 符号の分を除いた桁数に収まらない値は表示できない
+    uint8_t digits = width - is_negative;
+    if (digits < FORMAT_WIDTH_MAX && val >= pgm_read_word(&powers_of_ten[digits])) {
+        fill_overflow(buf, width);
+        return;
+    }
+    for (uint8_t i = width; i > 0; i--) {
+        uint16_t power = pgm_read_word(&powers_of_ten[i - 1]);
+        char c = '0';
+        while (val >= power) {
+            val -= power;
+            c++;
+        }
+        if (c == '0' && !is_nonzero_printed && i > 1) {
+            buf[pos++] = ' ';
+            continue;
+        }
+        if (!is_nonzero_printed && is_negative) buf[pos - 1] = '-';
+        is_nonzero_printed = true;
+        buf[pos++] = c;
+    }
+    buf[pos] = '\0';
+}
+
+void format_uint(char *buf, uint16_t val, uint8_t width) {
+    format_decimal(buf, val, width, false);
+}
+
+void format_int(char *buf, int16_t val, uint8_t width) {
+    bool is_negative = val < 0;
+    // -32768 も uint16_t なら正しく絶対値にできる
+    format_decimal(buf, is_negative ? -(uint16_t)val : (uint16_t)val, width, is_negative);
+}
+
+void format_hex(char *buf, uint16_t val, uint8_t width) {
+    if (width < 4 && (val >> (width * 4)) != 0) {
+        fill_overflow(buf, width);
+        return;
+    }
+    for (uint8_t i = width; i > 0; i--) {
+        buf[i - 1] = pgm_read_byte(&hex_digits[val & 0x0F]);
+        val >>= 4;
+    }
+    buf[width] = '\0';
+}
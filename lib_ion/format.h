@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+
+// Fixed-width integer formatters for the OLED (replacements of sprintf)
+// Every formatter writes exactly `width` characters and a terminating '\0' into buf,
+// so buf needs (width + 1) bytes. Values which do not fit into the width are shown as '#'s.
+#define FORMAT_WIDTH_MIN 2
+#define FORMAT_WIDTH_MAX 5
+#define FORMAT_BUFFER_SIZE(width) ((width) + 1)
+
+// Same as "%*u"
+void format_uint(char *buf, uint16_t val, uint8_t width);
+// Same as "%*d"
+void format_int(char *buf, int16_t val, uint8_t width);
+// Same as "%0*X"
+void format_hex(char *buf, uint16_t val, uint8_t width);
+
+// Checks the width and the size of the buffer at compile time: buf must be an array
+#define FORMAT_CHECK(buf, width) \
+    _Static_assert((width) >= FORMAT_WIDTH_MIN && (width) <= FORMAT_WIDTH_MAX, "unsupported width"); \
+    _Static_assert(sizeof(buf) >= FORMAT_BUFFER_SIZE(width), "buffer is too small")
+#define FORMAT_UINT(buf, val, width) do { FORMAT_CHECK(buf, width); format_uint(buf, val, width); } while (0)
+#define FORMAT_INT(buf, val, width) do { FORMAT_CHECK(buf, width); format_int(buf, val, width); } while (0)
+#define FORMAT_HEX(buf, val, width) do { FORMAT_CHECK(buf, width); format_hex(buf, val, width); } while (0)
@@ -0,0 +1,63 @@
+// スティック・ハットスイッチ・ボタンを1つのジョイスティックのレポートにまとめて、スキャンごとに1回だけ送る
+#include QMK_KEYBOARD_H
+#include "joystick.h"
+#include "lib_ion/gamepad.h"
+#include "lib_ion/gesture.h"
+#include "lib_ion/ram_func.h"
+
+#ifndef JOYSTICK_HAS_HAT
+#error "lib_ion/gamepad.c needs JOYSTICK_HAS_HAT in config.h"
+#endif
+
+RAM_FUNC void set_gamepad_button(uint8_t button, bool pressed) {
+    // register_joystick_button() はその場で送るので、ビットだけ変えてスキャンの最後にまとめて送る
+    if (button >= JOYSTICK_BUTTON_COUNT) return;
+    uint8_t mask = 1 << (button % 8);
+    if (pressed) joystick_state.buttons[button / 8] |= mask;
+    else joystick_state.buttons[button / 8] &= ~mask;
+    joystick_state.dirty = true;
+}
+
+RAM_FUNC bool process_gamepad(struct GAMEPAD_STATE *state, uint16_t keycode, keyrecord_t *record) {
+    bool pressed = record->event.pressed;
+    if (keycode >= QK_JOYSTICK_BUTTON_0 && keycode <= QK_JOYSTICK_BUTTON_MAX) {
+        set_gamepad_button(keycode - QK_JOYSTICK_BUTTON_0, pressed);
+        return false;
+    }
+    if (keycode >= state->hat_keycode && keycode < state->hat_keycode + 4) {
+        uint8_t mask = 1 << (keycode - state->hat_keycode);
+        if (pressed) state->hat_keys |= mask;
+        else state->hat_keys &= ~mask;
+        return false;
+    }
+    return true;
+}
+
+static RAM_FUNC int8_t hat_from_keys(uint8_t keys) {
+    // 反対の方向を同時に押したときは打ち消し合う
+    int8_t x = ((keys >> GAMEPAD_HAT_RIGHT) & 1) - ((keys >> GAMEPAD_HAT_LEFT) & 1);
+    int8_t y = ((keys >> GAMEPAD_HAT_DOWN) & 1) - ((keys >> GAMEPAD_HAT_UP) & 1);
+    if (x == 0 && y == 0) return JOYSTICK_HAT_CENTER;
+    // 方向の並び (上から時計回り) は HID のハットスイッチと同じ
+    return stick_direction(x, y);
+}
+
+RAM_FUNC bool report_gamepad(struct GAMEPAD_STATE *state, struct JOYSTICK_STATE *js_state) {
+    int8_t hat = hat_from_keys(state->hat_keys);
+    // スティックをゲームパッドに使わないときは中央にしておく (ハットスイッチのキーとボタンはそのまま送る)
+    int16_t x = js_state != NULL ? js_state->x : 0;
+    int16_t y = js_state != NULL ? js_state->y : 0;
+    if (state->stick_hat) {
+        uint32_t squared_length = (uint32_t)((int32_t)x * x) + (uint32_t)((int32_t)y * y);
+        if (hat == JOYSTICK_HAT_CENTER && squared_length >= (uint32_t)GAMEPAD_HAT_THRESHOLD * GAMEPAD_HAT_THRESHOLD) {
+            hat = stick_direction(x, y);
+        }
+        x = y = 0;
+    }
+    joystick_set_hat(hat);
+    joystick_set_axis(0, x);
+    joystick_set_axis(1, y);
+    bool is_sent = joystick_state.dirty;
+    joystick_flush();
+    return is_sent;
+}
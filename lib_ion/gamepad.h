@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "lib_ion/joystick.h"
+
+// Composite gamepad: the stick axes, an 8-way hat switch and up to 16 buttons are sent together
+// in the joystick report of QMK (JOYSTICK_HAS_HAT and JOYSTICK_BUTTON_COUNT in config.h).
+// The buttons (JS_0 ...) and the hat keys only change the report; report_gamepad() sends it
+// once per scan, so a scan with several changes is still one transfer.
+
+// Distance from the center (of JOYSTICK_MAX_VALUE) for the stick to press the hat
+#define GAMEPAD_HAT_THRESHOLD (JOYSTICK_MAX_VALUE / 2)
+
+// Hat keys: 4 consecutive custom keycodes of the keymap, in this order
+enum GAMEPAD_HAT_KEY {
+    GAMEPAD_HAT_UP,
+    GAMEPAD_HAT_RIGHT,
+    GAMEPAD_HAT_DOWN,
+    GAMEPAD_HAT_LEFT,
+};
+
+struct GAMEPAD_STATE {
+    uint16_t hat_keycode; // Keycode of GAMEPAD_HAT_UP
+    uint8_t hat_keys;     // Bits of the hat keys held (1 << GAMEPAD_HAT_*)
+    bool stick_hat;       // The stick presses the hat instead of moving the axes (d-pad mode)
+};
+
+#define GAMEPAD_INIT(hat_keycode) {hat_keycode, 0, false}
+// Called from process_record_user(): returns false for the buttons and the hat keys
+bool process_gamepad(struct GAMEPAD_STATE *state, uint16_t keycode, keyrecord_t *record);
+// Presses or releases a button in the report without sending it (also used by the rapid fire of lib_ion/joystick.c)
+void set_gamepad_button(uint8_t button, bool pressed);
+// Called from matrix_scan_user() after read_joystick_angles(), instead of report_joystick()
+// (the hat keys win over the stick when both are used). Returns true when a report was sent.
+// Call it in every stick mode: with js_state NULL (the stick moves the mouse or makes gestures)
+// the axes and the stick hat go back to the center, and the hat keys and the buttons are still sent.
+bool report_gamepad(struct GAMEPAD_STATE *state, struct JOYSTICK_STATE *js_state);
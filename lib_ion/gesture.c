@@ -0,0 +1,68 @@
+// スティックのジェスチャー (はじき・長押し・1/4回転・半回転) をスキャンごとに少しずつ判定する
+#include QMK_KEYBOARD_H
+#include "lib_ion/gesture.h"
+
+#define GESTURE_PHASE_CENTER 0
+#define GESTURE_PHASE_OUT 1
+#define GESTURE_PHASE_DONE 2
+
+uint8_t stick_direction(int16_t x, int16_t y) {
+    // atan を使わずに 22.5 度 (tan = 106 / 256) で8方向に分ける
+    int32_t ax = x < 0 ? -x : x;
+    int32_t ay = y < 0 ? -y : y;
+    if (ax * 256 < ay * 106) return y < 0 ? GESTURE_UP : GESTURE_DOWN;
+    if (ay * 256 < ax * 106) return x > 0 ? GESTURE_RIGHT : GESTURE_LEFT;
+    if (y < 0) return x > 0 ? GESTURE_UP_RIGHT : GESTURE_UP_LEFT;
+    return x > 0 ? GESTURE_DOWN_RIGHT : GESTURE_DOWN_LEFT;
+}
+
+uint8_t run_gesture(struct GESTURE_STATE *state, int16_t x, int16_t y, uint16_t now) {
+    // 16ビットの角度でも 2 * 32767^2 は uint32_t に収まる
+    uint32_t squared_length = (uint32_t)((int32_t)x * x) + (uint32_t)((int32_t)y * y);
+    if (squared_length < (uint32_t)GESTURE_CENTER * GESTURE_CENTER) {
+        // 中央に戻ったところで、はじき・回転を判定する
+        uint8_t phase = state->phase;
+        state->phase = GESTURE_PHASE_CENTER;
+        if (phase != GESTURE_PHASE_OUT) return GESTURE_NONE;
+        if (state->steps >= 4) return GESTURE_HALF_CW;
+        if (state->steps <= -4) return GESTURE_HALF_CCW;
+        if (state->steps >= 2) return GESTURE_QUARTER_CW;
+        if (state->steps <= -2) return GESTURE_QUARTER_CCW;
+        if ((uint16_t)(now - state->timer) < GESTURE_FLICK_TIME) return GESTURE_FLICK + state->start;
+        return GESTURE_NONE;
+    }
+    // 中央と閾値の間では何もしない
+    if (squared_length < (uint32_t)GESTURE_THRESHOLD * GESTURE_THRESHOLD) return GESTURE_NONE;
+    uint8_t direction = stick_direction(x, y);
+    if (state->phase == GESTURE_PHASE_CENTER) {
+        state->phase = GESTURE_PHASE_OUT;
+        state->start = state->direction = direction;
+        state->steps = 0;
+        state->timer = state->hold_timer = now;
+        return GESTURE_NONE;
+    }
+    if (state->phase == GESTURE_PHASE_DONE) return GESTURE_NONE;
+    if (direction != state->direction) {
+        // 隣の方向へ動いた分を数える (速く回すと1スキャンで2-3方向飛ぶこともある)
+        uint8_t delta = (direction - state->direction) & 7;
+        if (delta < 4) state->steps += delta;
+        else if (delta > 4) state->steps -= 8 - delta;
+        // 何周も回したときにあふれないように1周で止める
+        if (state->steps > 8) state->steps = 8;
+        if (state->steps < -8) state->steps = -8;
+        state->direction = direction;
+        state->hold_timer = now;
+        return GESTURE_NONE;
+    }
+    // 回さずに同じ方向に倒したままなら長押し (一度だけ)
+    if (state->steps == 0 && (uint16_t)(now - state->hold_timer) >= GESTURE_HOLD_TIME) {
+        state->phase = GESTURE_PHASE_DONE;
+        return GESTURE_HOLD + direction;
+    }
+    return GESTURE_NONE;
+}
+
+uint16_t gesture_keycode(const uint16_t *table, uint8_t gesture) {
+    if (gesture >= GESTURE_COUNT) return KC_NO;
+    return pgm_read_word(&table[gesture]);
+}
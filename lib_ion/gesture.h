@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Stick gestures: flicks and holds in 8 directions, quarter and half circles.
+// run_gesture() is called every scan with the stick and keeps only a few bytes of state.
+
+// Distance from the center (of JOYSTICK_MAX_VALUE) to start a gesture
+#define GESTURE_THRESHOLD (JOYSTICK_MAX_VALUE * 2 / 3)
+// Distance to be back at the center (lower than the threshold to ignore the jitter at the edge)
+#define GESTURE_CENTER (JOYSTICK_MAX_VALUE / 4)
+// A flick is out and back to the center within this time (ms)
+#define GESTURE_FLICK_TIME 200
+// A hold is kept in one direction for this time (ms)
+#define GESTURE_HOLD_TIME 500
+
+// Directions: clockwise from up
+enum GESTURE_DIRECTION {
+    GESTURE_UP,
+    GESTURE_UP_RIGHT,
+    GESTURE_RIGHT,
+    GESTURE_DOWN_RIGHT,
+    GESTURE_DOWN,
+    GESTURE_DOWN_LEFT,
+    GESTURE_LEFT,
+    GESTURE_UP_LEFT,
+};
+
+// Gestures: GESTURE_FLICK + direction, GESTURE_HOLD + direction
+enum GESTURE {
+    GESTURE_NONE,
+    GESTURE_FLICK,
+    GESTURE_HOLD = GESTURE_FLICK + 8,
+    GESTURE_QUARTER_CW = GESTURE_HOLD + 8,
+    GESTURE_QUARTER_CCW,
+    GESTURE_HALF_CW,
+    GESTURE_HALF_CCW,
+    GESTURE_COUNT,
+};
+
+struct GESTURE_STATE {
+    uint8_t phase;        // Center, out of the center, or done (waiting for the center)
+    uint8_t start;        // Direction where the stick left the center
+    uint8_t direction;    // Current direction
+    int8_t steps;         // Directions turned since the start (clockwise: positive)
+    uint16_t timer;       // Time when the stick left the center
+    uint16_t hold_timer;  // Time when the stick entered the current direction
+};
+
+#define GESTURE_INIT {0, 0, 0, 0, 0, 0}
+// Direction of the stick (GESTURE_UP ...) in 8 sectors of 45 degrees, for any distance from the center
+uint8_t stick_direction(int16_t x, int16_t y);
+// Returns a gesture (GESTURE_NONE most of the time); y is negative for up
+uint8_t run_gesture(struct GESTURE_STATE *state, int16_t x, int16_t y, uint16_t now);
+// Keycode bound to a gesture: table is a PROGMEM array of GESTURE_COUNT keycodes
+// (tap it with tap_code16(), or pass a macro keycode to process_macro_keycode())
+uint16_t gesture_keycode(const uint16_t *table, uint8_t gesture);
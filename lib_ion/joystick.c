@@ -2,53 +2,128 @@
 #include "analog.h"
 #include "joystick.h"
 #include "lib_ion/joystick.h"
+#include "lib_ion/ram_func.h"
+#ifdef GAMEPAD_REPORT
+#include "lib_ion/gamepad.h"
+#endif
 
-bool is_in_deadzone(int16_t x, int16_t y, uint16_t dz) {
-    // x, y はそれぞれ -512 - 511 程度なので2乗しても高々2^19程度に収まる
+RAM_FUNC bool is_in_deadzone(int16_t x, int16_t y, uint32_t squared_dz) {
+    // x, y は中央からの距離で 12 ビットの ADC でも ±4095 以内なので、2乗の和は 2^25 程度に収まる
     uint32_t squared_length = (uint32_t)x * x + (uint32_t)y * y;
-    uint32_t squared_deadzone = (uint32_t)dz * dz;
-    return squared_length < squared_deadzone;
+    return squared_length < squared_dz;
 } 
 
-int16_t joystick_angle(int16_t raw, int16_t min, int16_t mid, int16_t max) {
-    int32_t val = (raw - mid) * JOYSTICK_MAX_VALUE / (mid - min);
-    // 負の値であるはずが正の値になっている場合はおかしいので高い方でやり直し
-    if (val > 0) val = (raw - mid) * JOYSTICK_MAX_VALUE / (max - mid);
-    // 最小値・最大値でクリップする
-    return val < -JOYSTICK_MAX_VALUE ? -JOYSTICK_MAX_VALUE : val > JOYSTICK_MAX_VALUE ? JOYSTICK_MAX_VALUE : val;
+RAM_FUNC int16_t joystick_angle(int16_t raw, const struct JOYSTICK_AXIS_CALIBRATION *calibration) {
+    // 中央からの距離をその側の幅でクリップしてから、事前に計算した係数を掛けて 2^JS_ANGLE_SHIFT で割る (除算を使わない)
+    int16_t distance = raw - calibration->mid;
+    bool is_high = (distance > 0) == (calibration->high > calibration->mid);
+    uint16_t length = distance < 0 ? -distance : distance;
+    uint16_t range = is_high ? calibration->high_range : calibration->low_range;
+    if (length > range) length = range;
+    int16_t val = ((uint32_t)length * (is_high ? calibration->high_scale : calibration->low_scale)) >> JS_ANGLE_SHIFT;
+    return is_high ? val : -val;
 }
 
-void read_joystick_angles(struct JOYSTICK_STATE *state) {
+bool set_joystick_calibration(struct JOYSTICK_AXIS_CALIBRATION *calibration, int16_t low, int16_t mid, int16_t high) {
+    // 中央が両端の間にないと向きが決まらない
+    if (low == mid || mid == high || (low < mid) != (mid < high)) return false;
+    calibration->low = low;
+    calibration->mid = mid;
+    calibration->high = high;
+    calibration->low_range = JS_AXIS_RANGE(low, mid);
+    calibration->high_range = JS_AXIS_RANGE(mid, high);
+    calibration->low_scale = JS_AXIS_SCALE(calibration->low_range);
+    calibration->high_scale = JS_AXIS_SCALE(calibration->high_range);
+    return true;
+}
+
+void update_joystick_profile(struct JOYSTICK_PROFILE *profile) {
+    // 設定を変えたときに一度だけ計算する
+    profile->squared_deadzone = (uint32_t)profile->deadzone * profile->deadzone;
+    profile->mouse_scale = (32768U + profile->mouse_speed - 1) / profile->mouse_speed;
+}
+
+static RAM_FUNC int16_t square_angle(int16_t val) {
+    // 符号を残したまま2乗して元の範囲に戻す。v / JOYSTICK_MAX_VALUE (= 2^n - 1) を (v + (v >> n) + 1) >> n で計算する
+    // |val| <= JOYSTICK_MAX_VALUE では除算と同じ値になる (16ビットでも 32767^2 は uint32_t に収まる)
+    uint16_t length = val < 0 ? -val : val;
+    uint32_t squared = (uint32_t)length * length;
+    int16_t scaled = (squared + (squared >> (JOYSTICK_AXIS_RESOLUTION - 1)) + 1) >> (JOYSTICK_AXIS_RESOLUTION - 1);
+    return val < 0 ? -scaled : scaled;
+}
+
+RAM_FUNC void read_joystick_angles(struct JOYSTICK_STATE *state) {
     if (!state->enabled) {
         state->x = state->y = 0;
         return;
     }
     struct JOYSTICK_ANGLES raw = { analogReadPin(JS_PIN_X), analogReadPin(JS_PIN_Y) };
-    bool is_dz = is_in_deadzone(raw.x - JS_X_MED, raw.y - JS_Y_MED, JS_DEADZONE);
+    map_joystick_angles(state, raw);
+}
+
+RAM_FUNC void map_joystick_angles(struct JOYSTICK_STATE *state, struct JOYSTICK_ANGLES raw) {
+    state->raw = raw;
+    bool is_dz = is_in_deadzone(raw.x - state->calibration[0].mid, raw.y - state->calibration[1].mid, state->profile.squared_deadzone);
     if (is_dz) {
         state->x = state->y = 0;
         return;
     }
-    state->x = joystick_angle(raw.x, JS_X_MAX, JS_X_MED, JS_X_MIN);
-    state->y = joystick_angle(raw.y, JS_Y_MIN, JS_Y_MED, JS_Y_MAX);
+    state->x = joystick_angle(raw.x, &state->calibration[0]);
+    state->y = joystick_angle(raw.y, &state->calibration[1]);
+    if (state->profile.curve == JS_CURVE_QUADRATIC) {
+        state->x = square_angle(state->x);
+        state->y = square_angle(state->y);
+    }
 }
 
-void report_joystick(struct JOYSTICK_STATE *state, uint8_t x_axis, uint8_t y_axis) {
+RAM_FUNC bool report_joystick(struct JOYSTICK_STATE *state, uint8_t x_axis, uint8_t y_axis) {
     // The resolution of ADCs are 10bit: 0 - 1023
-    // A virtual joystick has a range of -128 - 127 (int8_t)
+    // A virtual joystick has a range of -JOYSTICK_MAX_VALUE - JOYSTICK_MAX_VALUE (int8_t or int16_t by JOYSTICK_AXIS_RESOLUTION)
     joystick_set_axis(x_axis, state->x); // X軸
     joystick_set_axis(y_axis, state->y); // Y軸
+    // 値が変わらなければ joystick_flush() は送らない
+    bool is_sent = joystick_state.dirty;
     joystick_flush();
+    return is_sent;
+}
+
+static RAM_FUNC int16_t scale_mouse(int16_t val, uint16_t scale) {
+    // val / speed を val * (32768 / speed) / 32768 で計算する (0 に向かって丸めるのは除算と同じ)
+    // 8ビットより細かい分も同じシフトで落とすので、マウスの速さは解像度によらない
+    int32_t scaled = ((int32_t)(val < 0 ? -val : val) * scale) >> JS_MOUSE_SHIFT;
+    return val < 0 ? -scaled : scaled;
 }
 
-void report_joystick_as_mouse(struct JOYSTICK_STATE *js_state) {
+RAM_FUNC void report_joystick_as_mouse(struct JOYSTICK_STATE *js_state) {
     report_mouse_t mo = pointing_device_get_report();
-    mo.x = js_state->x / JS_MOUSE_SPEED;
-    mo.y = js_state->y / JS_MOUSE_SPEED;
+    mo.x = scale_mouse(js_state->x, js_state->profile.mouse_scale);
+    mo.y = scale_mouse(js_state->y, js_state->profile.mouse_scale);
     pointing_device_set_report(mo);
     pointing_device_send();
 }
 
+void load_joystick_profile(struct JOYSTICK_STATE *state, struct JOYSTICK_RAPID_STATE *rapid_state, const struct JOYSTICK_PROFILE *table, uint8_t count, uint8_t layer) {
+    // レイヤー番号で表を引くだけなので、レイヤーやプロファイルの数によらず一定の時間で切り替わる
+    if (layer >= count) layer = 0;
+    memcpy_P(&state->profile, &table[layer], sizeof(struct JOYSTICK_PROFILE));
+    rapid_state->interval = state->profile.rapid_interval;
+}
+
+void set_joystick_profile(struct JOYSTICK_STATE *state, struct JOYSTICK_RAPID_STATE *rapid_state, const struct JOYSTICK_PROFILE *profile) {
+    state->profile = *profile;
+    rapid_state->interval = profile->rapid_interval;
+}
+
+static RAM_FUNC void set_rapid_button(uint8_t button, bool pressed) {
+    #ifdef GAMEPAD_REPORT
+    // report_gamepad() がスティックと一緒に送るので、連打でレポートを増やさない
+    set_gamepad_button(button, pressed);
+    #else
+    if (pressed) register_joystick_button(button);
+    else unregister_joystick_button(button);
+    #endif
+}
+
 void start_joystick_rapid(struct JOYSTICK_RAPID_STATE *state) {
     state->enabled = true;
     state->timer = timer_read();
@@ -56,7 +131,7 @@ void start_joystick_rapid(struct JOYSTICK_RAPID_STATE *state) {
 
 void stop_joystick_rapid(struct JOYSTICK_RAPID_STATE *state) {
     state->enabled = false;
-    unregister_joystick_button(state->button);
+    set_rapid_button(state->button, false);
 }
 
 void toggle_joystick_rapid(struct JOYSTICK_RAPID_STATE *state) {
@@ -64,13 +139,48 @@ void toggle_joystick_rapid(struct JOYSTICK_RAPID_STATE *state) {
     else start_joystick_rapid(state);
 }
 
-void run_joystick_rapid(struct JOYSTICK_RAPID_STATE *state) {
-    if (!state->enabled || timer_elapsed(state->timer) < JS_RAPID_INTERVAL) return;
-    if (state->pressing) {
-        unregister_joystick_button(state->button);
-    } else {
-        register_joystick_button(state->button);
-    }
+RAM_FUNC bool run_joystick_rapid(struct JOYSTICK_RAPID_STATE *state) {
+    if (!state->enabled || timer_elapsed(state->timer) < state->interval) return false;
     state->pressing = !state->pressing;
+    set_rapid_button(state->button, state->pressing);
     state->timer = timer_read();
-}
\ No newline at end of file
+    return true;
+}
+#ifdef JS_BENCHMARK
+#include "lib_ion/timer_us.h"
+#if defined(MCU_RP)
+// XIP_CTRL の FLUSH レジスタ: 1 を書くとキャッシュを空にし、読むと空になるまで待つ (RP2040 datasheet 2.6.3.1)
+#define XIP_CTRL_FLUSH (*(volatile uint32_t *)0x14000004)
+#endif
+
+static uint16_t time_joystick_mapping(struct JOYSTICK_STATE *state, bool is_cold) {
+    #if defined(MCU_RP)
+    if (is_cold) {
+        XIP_CTRL_FLUSH = 1;
+        (void)XIP_CTRL_FLUSH;
+    }
+    #endif
+    uint16_t start = read_timer_us();
+    map_joystick_angles(state, state->raw);
+    return read_timer_us() - start;
+}
+
+void run_joystick_benchmark(struct JOYSTICK_BENCHMARK *result, const struct JOYSTICK_STATE *state) {
+    // 不感帯・キャリブレーション・2乗のカーブを全部通るように、両軸とも端まで倒した値で測る
+    struct JOYSTICK_STATE copy = *state;
+    copy.profile.curve = JS_CURVE_QUADRATIC;
+    copy.raw.x = copy.calibration[0].high;
+    copy.raw.y = copy.calibration[1].high;
+    *result = (struct JOYSTICK_BENCHMARK){UINT16_MAX, 0, UINT16_MAX, 0};
+    // 最初の1回はキャッシュに乗せるためだけに実行する
+    time_joystick_mapping(&copy, false);
+    for (uint16_t i = 0; i < JS_BENCHMARK; i++) {
+        uint16_t warm = time_joystick_mapping(&copy, false);
+        uint16_t cold = time_joystick_mapping(&copy, true);
+        if (warm < result->warm_min) result->warm_min = warm;
+        if (warm > result->warm_max) result->warm_max = warm;
+        if (cold < result->cold_min) result->cold_min = cold;
+        if (cold > result->cold_max) result->cold_max = cold;
+    }
+}
+#endif
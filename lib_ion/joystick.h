@@ -1,49 +1,124 @@
 #pragma once
+#include "lib_ion/stick_adc.h"
 
 // Debug mode: show the joystick angles to OLED (comment out or undef this to disable)
 #define JS_DEBUG_ENABLED
 
 #define JS_DEFAULT_ENABLED true
-// Deadzone: stick tilting values lower than this value are ignored
-#define JS_DEADZONE 64
-// Pins
-#define JS_PIN_X F5
-#define JS_PIN_Y F4
-// ADC Measured value
-#define JS_X_MIN 172
-#define JS_X_MED 444
-#define JS_X_MAX 784
-
-#define JS_Y_MIN 244
-#define JS_Y_MED 532
-#define JS_Y_MAX 822
+// Deadzone: stick tilting values lower than this value are ignored (raw ADC value)
+#define JS_DEADZONE JS_ADC_10BIT(64)
+// The board supplies the stick in its config.h: the pins (JS_PIN_X, JS_PIN_Y) and the raw ADC values at
+// the left/top end, the center and the right/bottom end (JS_X_LOW, JS_X_MID, JS_X_HIGH, JS_Y_*),
+// which are the defaults of the calibration (can be changed at runtime by lib_ion/settings.h)
+#if !defined(JS_PIN_X) || !defined(JS_PIN_Y) || !defined(JS_X_MID) || !defined(JS_Y_MID)
+#error "The stick pins and calibration (JS_PIN_X, JS_X_LOW ...) are not defined in the config.h of the board"
+#endif
 
 #define JS_RAPID_INTERVAL 60
-// 0 (Fastest) - 127 (Slowest)
+// 1 (Fastest) - 127 (Slowest)
 #define JS_MOUSE_SPEED 20
 
+// Curves: how the stick tilt is mapped to the output
+#define JS_CURVE_LINEAR 0
+#define JS_CURVE_QUADRATIC 1 // Finer control near the center
+
+// Stick behavior of a layer: a PROGMEM table indexed by layer is copied into JOYSTICK_STATE
+// by load_joystick_profile() when the layer is changed
+struct JOYSTICK_PROFILE {
+    bool is_mouse;
+    uint8_t curve;
+    uint16_t deadzone;
+    uint16_t rapid_interval;
+    // Precomputed by JS_PROFILE() or update_joystick_profile() so that the matrix scan needs no division
+    uint32_t squared_deadzone;
+    uint16_t mouse_scale; // 32768 / mouse speed (rounded up: same result as the division for -127 - 127)
+    uint8_t mouse_speed;
+};
+// The mouse speed is for 8 bit angles: higher resolutions are scaled down with the division by the speed
+#define JS_MOUSE_SHIFT (15 + JOYSTICK_AXIS_RESOLUTION - 8)
+// JS_PROFILE(mouse mode, curve, deadzone, rapid fire interval (ms), mouse speed (1 - 127))
+#define JS_PROFILE(mouse, curve, dz, interval, speed) {mouse, curve, dz, interval, (uint32_t)(dz) * (dz), (32768U + (speed) - 1) / (speed), speed}
+#define JS_PROFILE_DEFAULT JS_PROFILE(false, JS_CURVE_LINEAR, JS_DEADZONE, JS_RAPID_INTERVAL, JS_MOUSE_SPEED)
+
+// Calibration of an axis: the raw ADC values at -JOYSTICK_MAX_VALUE, the center and +JOYSTICK_MAX_VALUE
+// (low > high inverts the axis)
+struct JOYSTICK_AXIS_CALIBRATION {
+    int16_t low;
+    int16_t mid;
+    int16_t high;
+    // Precomputed by JS_AXIS_CALIBRATION() or set_joystick_calibration() so that the matrix scan needs no division
+    uint16_t low_range;  // |mid - low|
+    uint16_t high_range; // |high - mid|
+    uint32_t low_scale;  // JOYSTICK_MAX_VALUE * 2^JS_ANGLE_SHIFT / low_range (rounded up)
+    uint32_t high_scale;
+};
+// JOYSTICK_MAX_VALUE * 2^JS_ANGLE_SHIFT stays below 2^31 for any JOYSTICK_AXIS_RESOLUTION (8 - 16).
+// 8 bits: 24, same result as the division. 16 bits: 16, at most 1 above the division (never above JOYSTICK_MAX_VALUE).
+#define JS_ANGLE_SHIFT (32 - JOYSTICK_AXIS_RESOLUTION)
+#define JS_AXIS_RANGE(from, to) ((from) < (to) ? (to) - (from) : (from) - (to))
+#define JS_AXIS_SCALE(range) ((((uint32_t)JOYSTICK_MAX_VALUE << JS_ANGLE_SHIFT) + (range) - 1) / (range))
+#define JS_AXIS_CALIBRATION(low, mid, high) {low, mid, high, JS_AXIS_RANGE(low, mid), JS_AXIS_RANGE(mid, high), \
+    JS_AXIS_SCALE(JS_AXIS_RANGE(low, mid)), JS_AXIS_SCALE(JS_AXIS_RANGE(mid, high))}
+#define JS_CALIBRATION_DEFAULT {JS_AXIS_CALIBRATION(JS_X_LOW, JS_X_MID, JS_X_HIGH), JS_AXIS_CALIBRATION(JS_Y_LOW, JS_Y_MID, JS_Y_HIGH)}
+
+// Angles are -JOYSTICK_MAX_VALUE - JOYSTICK_MAX_VALUE: 127 with JOYSTICK_AXIS_RESOLUTION 8, 32767 with 16.
+// The deadzone and the calibration are in raw ADC values, so they don't depend on the resolution.
+// Angle in 8 bits (-127 - 127) for the displays
+#define JS_ANGLE_8BIT(val) ((val) / (1 << (JOYSTICK_AXIS_RESOLUTION - 8)))
 struct JOYSTICK_ANGLES { int16_t x; int16_t y; };
 struct JOYSTICK_STATE {
     int16_t x;
     int16_t y;
     bool enabled;
+    struct JOYSTICK_PROFILE profile;
+    struct JOYSTICK_ANGLES raw; // ADC values of the last read (kept while disabled)
+    struct JOYSTICK_AXIS_CALIBRATION calibration[2]; // X, Y
 };
 struct JOYSTICK_RAPID_STATE {
     uint8_t button;
     bool enabled;
     bool pressing;
     uint16_t timer;
+    uint16_t interval;
 };
 
-#define JS_INIT {0, 0, JS_DEFAULT_ENABLED}
-bool is_in_deadzone(int16_t x, int16_t y, uint16_t dz);
-int16_t joystick_angle(int16_t raw, int16_t min, int16_t mid, int16_t max);
+#define JS_INIT {0, 0, JS_DEFAULT_ENABLED, JS_PROFILE_DEFAULT, {0, 0}, JS_CALIBRATION_DEFAULT}
+bool is_in_deadzone(int16_t x, int16_t y, uint32_t squared_dz);
+// Maps a raw ADC value to -JOYSTICK_MAX_VALUE - JOYSTICK_MAX_VALUE (clipped)
+int16_t joystick_angle(int16_t raw, const struct JOYSTICK_AXIS_CALIBRATION *calibration);
+// Sets the calibration and its precomputed values, false (and nothing changed) if the center is not between the ends
+bool set_joystick_calibration(struct JOYSTICK_AXIS_CALIBRATION *calibration, int16_t low, int16_t mid, int16_t high);
+// Recomputes the precomputed values of a profile after deadzone or mouse_speed was changed
+void update_joystick_profile(struct JOYSTICK_PROFILE *profile);
+// Reads the ADC and maps it with map_joystick_angles()
 void read_joystick_angles(struct JOYSTICK_STATE *state);
-void report_joystick(struct JOYSTICK_STATE *state, uint8_t x_axis, uint8_t y_axis);
+// Deadzone, calibration and curve of raw ADC values into state->x, state->y
+void map_joystick_angles(struct JOYSTICK_STATE *state, struct JOYSTICK_ANGLES raw);
+// Returns true when a report was sent (QMK skips it when the axes did not change)
+bool report_joystick(struct JOYSTICK_STATE *state, uint8_t x_axis, uint8_t y_axis);
 void report_joystick_as_mouse(struct JOYSTICK_STATE *js_state);
+// Copies table[layer] (table[0] for the layers after the table) and the rapid fire interval
+void load_joystick_profile(struct JOYSTICK_STATE *state, struct JOYSTICK_RAPID_STATE *rapid_state, const struct JOYSTICK_PROFILE *table, uint8_t count, uint8_t layer);
+// Same as load_joystick_profile() with a profile in RAM
+void set_joystick_profile(struct JOYSTICK_STATE *state, struct JOYSTICK_RAPID_STATE *rapid_state, const struct JOYSTICK_PROFILE *profile);
 
-#define JS_RAPID_INIT(B) {B, false, false, 0}
+#define JS_RAPID_INIT(B) {B, false, false, 0, JS_RAPID_INTERVAL}
 void start_joystick_rapid(struct JOYSTICK_RAPID_STATE *state);
 void stop_joystick_rapid(struct JOYSTICK_RAPID_STATE *state);
 void toggle_joystick_rapid(struct JOYSTICK_RAPID_STATE *state);
-void run_joystick_rapid(struct JOYSTICK_RAPID_STATE *state);
+// Returns true when the button was pressed or released. The joystick report is sent at once, except
+// with GAMEPAD_REPORT: then the button only changes the report and report_gamepad() sends it with the stick.
+bool run_joystick_rapid(struct JOYSTICK_RAPID_STATE *state);
+
+#ifdef JS_BENCHMARK
+// Run time of map_joystick_angles() (us) over JS_BENCHMARK runs, measured by run_joystick_benchmark().
+// The difference between cold_max and warm_min is the jitter a cache miss adds to the stick path.
+struct JOYSTICK_BENCHMARK {
+    uint16_t warm_min;  // the code was run just before (in the XIP cache or in the SRAM)
+    uint16_t warm_max;
+    uint16_t cold_min;  // the XIP cache was flushed before each run (RP2040, the same as warm elsewhere)
+    uint16_t cold_max;
+};
+// Measures with a copy of state, tilted to the high ends so the whole mapping runs (needs lib_ion/timer_us.c)
+void run_joystick_benchmark(struct JOYSTICK_BENCHMARK *result, const struct JOYSTICK_STATE *state);
+#endif
@@ -0,0 +1,63 @@
+// ほとんど XXXXXXX のレイヤーを、基準のレイヤーとの差分だけで持つ
+#include QMK_KEYBOARD_H
+#include "keymap_introspection.h"
+#include "lib_ion/keymap_sparse.h"
+#include "lib_ion/ram_func.h"
+
+static void expand_sparse_layer(struct SPARSE_CACHE *cache, uint8_t layer, const struct SPARSE_LAYER *sparse) {
+    uint8_t base = pgm_read_byte(&sparse->base);
+    uint8_t count = pgm_read_byte(&sparse->count);
+    const struct SPARSE_KEY *keys = pgm_read_ptr(&sparse->keys);
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            cache->keycodes[row][col] = keycode_at_keymap_location(base, row, col);
+        }
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t pos = pgm_read_byte(&keys[i].pos);
+        cache->keycodes[pos / MATRIX_COLS][pos % MATRIX_COLS] = pgm_read_word(&keys[i].keycode);
+    }
+    cache->layer = layer;
+}
+
+RAM_FUNC uint16_t sparse_keycode(struct SPARSE_CACHE *cache, uint8_t layer, uint8_t row, uint8_t col, uint8_t first, const struct SPARSE_LAYER *table, uint8_t count) {
+    if (layer < first || layer - first >= count || row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+        return keycode_at_keymap_location(layer, row, col);
+    }
+    // レイヤーが変わったときだけ展開し直す (TO() で切り替えるので、普段は同じレイヤーが続く)
+    if (cache->layer != layer) expand_sparse_layer(cache, layer, &table[layer - first]);
+    return cache->keycodes[row][col];
+}
+
+#ifdef SPARSE_KEYMAP_BENCHMARK
+#include "lib_ion/timer_us.h"
+// レイヤーの展開は時間がかかるので、回数を減らして 16 ビットの us に収める
+#define SPARSE_BENCHMARK_MISSES (SPARSE_KEYMAP_BENCHMARK / 10)
+
+void run_sparse_benchmark(struct SPARSE_BENCHMARK *result, struct SPARSE_CACHE *cache, uint8_t first, const struct SPARSE_LAYER *table, uint8_t count) {
+    // 全てのキーを順に引く。結果は volatile に書いて、最適化で消えないようにする
+    volatile uint16_t keycode;
+    uint8_t row = 0, col = 0;
+    uint16_t start = read_timer_us();
+    for (uint16_t i = 0; i < SPARSE_KEYMAP_BENCHMARK; i++) {
+        keycode = keycode_at_keymap_location(0, row, col);
+        if (++col == MATRIX_COLS) col = 0, row = (row + 1) % MATRIX_ROWS;
+    }
+    result->dense_ns = (uint32_t)(uint16_t)(read_timer_us() - start) * 1000 / SPARSE_KEYMAP_BENCHMARK;
+    sparse_keycode(cache, first, 0, 0, first, table, count);
+    start = read_timer_us();
+    for (uint16_t i = 0; i < SPARSE_KEYMAP_BENCHMARK; i++) {
+        keycode = sparse_keycode(cache, first, row, col, first, table, count);
+        if (++col == MATRIX_COLS) col = 0, row = (row + 1) % MATRIX_ROWS;
+    }
+    result->hit_ns = (uint32_t)(uint16_t)(read_timer_us() - start) * 1000 / SPARSE_KEYMAP_BENCHMARK;
+    start = read_timer_us();
+    for (uint16_t i = 0; i < SPARSE_BENCHMARK_MISSES; i++) {
+        cache->layer = 0xFF;
+        keycode = sparse_keycode(cache, first, row, col, first, table, count);
+    }
+    result->miss_us = (uint16_t)(read_timer_us() - start) / SPARSE_BENCHMARK_MISSES;
+    (void)keycode;
+    cache->layer = 0xFF;
+}
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+
+// Sparse layers: a layer stored as the keys that differ from a full layer in keymaps[].
+// The full layers come first (0 .. first - 1) and the sparse layers follow them.
+
+// A key of a sparse layer: SK(row, col, keycode) with the matrix position (see keyboard.json)
+struct SPARSE_KEY {
+    uint8_t pos; // row * MATRIX_COLS + col
+    uint16_t keycode;
+};
+#define SK(row, col, kc) {(row) * MATRIX_COLS + (col), kc}
+
+struct SPARSE_LAYER {
+    uint8_t base; // Full layer used for the keys not in keys[]
+    uint8_t count;
+    const struct SPARSE_KEY *keys;
+};
+#define SPARSE_LAYER(base, keys) {base, ARRAY_SIZE(keys), keys}
+
+// The last used sparse layer is expanded in RAM, so a lookup costs the same as keymaps[]
+struct SPARSE_CACHE {
+    uint8_t layer; // 0xFF: empty
+    uint16_t keycodes[MATRIX_ROWS][MATRIX_COLS];
+};
+
+#define SPARSE_CACHE_INIT {0xFF, {{0}}}
+// Call from keymap_key_to_keycode() of the keymap
+uint16_t sparse_keycode(struct SPARSE_CACHE *cache, uint8_t layer, uint8_t row, uint8_t col, uint8_t first, const struct SPARSE_LAYER *table, uint8_t count);
+
+#ifdef SPARSE_KEYMAP_BENCHMARK
+// Time of one lookup over SPARSE_KEYMAP_BENCHMARK lookups, measured by run_sparse_benchmark()
+struct SPARSE_BENCHMARK {
+    uint16_t dense_ns;  // keycode_at_keymap_location() of a full layer (keymaps[] in PROGMEM)
+    uint16_t hit_ns;    // sparse_keycode() of the layer in the cache
+    uint16_t miss_us;   // sparse_keycode() after a layer change (expands the layer into the cache)
+};
+// Measures with the layers first and 0, and leaves the cache empty (needs lib_ion/timer_us.c)
+void run_sparse_benchmark(struct SPARSE_BENCHMARK *result, struct SPARSE_CACHE *cache, uint8_t first, const struct SPARSE_LAYER *table, uint8_t count);
+#endif
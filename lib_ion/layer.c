@@ -0,0 +1,21 @@
+// 最上位のレイヤーを変更時に一度だけ計算して覚えておく
+#include QMK_KEYBOARD_H
+#include "lib_ion/layer.h"
+
+layer_state_t update_layer_cache(struct LAYER_CACHE *cache, layer_state_t state) {
+    uint8_t layer = get_highest_layer(state);
+    if (layer != cache->layer) {
+        cache->previous = cache->layer;
+        cache->layer = layer;
+        cache->seq++;
+        // 0 は読み手の初期値なので使わない
+        if (cache->seq == 0) cache->seq = 1;
+    }
+    return state;
+}
+
+bool is_layer_changed(struct LAYER_CACHE *cache, uint8_t *seen_seq) {
+    if (*seen_seq == cache->seq) return false;
+    *seen_seq = cache->seq;
+    return true;
+}
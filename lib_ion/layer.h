@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Highest active layer kept up to date by layer_state_set_user(),
+// so renderers, lighting and profiles do not scan layer_state every frame
+struct LAYER_CACHE {
+    uint8_t layer;    // get_highest_layer(layer_state)
+    uint8_t previous; // Layer before the last change
+    uint8_t seq;      // Incremented on every change of layer
+};
+
+// seq starts at 1 so that readers starting at 0 see the first layer as a change
+#define LAYER_CACHE_INIT {0, 0, 1}
+// Call from layer_state_set_user() and return its result
+layer_state_t update_layer_cache(struct LAYER_CACHE *cache, layer_state_t state);
+// Returns true once per change of layer for each reader (seen_seq: the reader's copy of seq, initially 0)
+bool is_layer_changed(struct LAYER_CACHE *cache, uint8_t *seen_seq);
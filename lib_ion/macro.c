@@ -0,0 +1,131 @@
+// SEND_STRING(SS_DELAY(...)) の代わりにマクロを待たずに少しずつ実行する
+#include QMK_KEYBOARD_H
+#include "lib_ion/macro.h"
+
+static void hold_macro_key(struct MACRO_STATE *state, uint16_t keycode) {
+    // 空きがなければ押さない (覚えておけないキーはマクロの終わりや中断で離せず、押したままになる)
+    for (uint8_t i = 0; i < MACRO_MAX_HELD; i++) {
+        if (state->held[i] == KC_NO) {
+            state->held[i] = keycode;
+            register_code16(keycode);
+            return;
+        }
+    }
+}
+
+static void release_macro_key(struct MACRO_STATE *state, uint16_t keycode) {
+    unregister_code16(keycode);
+    for (uint8_t i = 0; i < MACRO_MAX_HELD; i++) {
+        if (state->held[i] == keycode) state->held[i] = KC_NO;
+    }
+}
+
+static void release_macro_keys(struct MACRO_STATE *state) {
+    for (uint8_t i = 0; i < MACRO_MAX_HELD; i++) {
+        if (state->held[i] != KC_NO) unregister_code16(state->held[i]);
+        state->held[i] = KC_NO;
+    }
+    if (state->wrapped_mods) unregister_mods(state->wrapped_mods);
+    state->wrapped_mods = 0;
+}
+
+bool start_macro(struct MACRO_STATE *state, const uint8_t *steps) {
+    if (state->step != NULL) {
+        #if MACRO_CONFLICT_POLICY == MACRO_POLICY_IGNORE
+        return false;
+        #elif MACRO_CONFLICT_POLICY == MACRO_POLICY_REPLACE
+        stop_macros(state);
+        #else
+        if (state->queue_count == MACRO_QUEUE_SIZE) return false;
+        state->queue[(state->queue_head + state->queue_count) % MACRO_QUEUE_SIZE] = steps;
+        state->queue_count++;
+        return true;
+        #endif
+    }
+    state->step = steps;
+    state->delay = 0;
+    // 最初のステップはすぐに実行する (遅延なし)
+    run_macros(state);
+    return true;
+}
+
+void stop_macros(struct MACRO_STATE *state) {
+    release_macro_keys(state);
+    state->step = NULL;
+    state->queue_count = 0;
+}
+
+void run_macros(struct MACRO_STATE *state) {
+    if (state->step == NULL) return;
+    if (state->delay > 0) {
+        if (timer_elapsed(state->timer) < state->delay) return;
+        state->delay = 0;
+    }
+    // 待ち時間のあるステップまでをまとめて実行する
+    while (true) {
+        uint8_t op = pgm_read_byte(state->step++);
+        uint8_t bits = op & 0x1F;
+        switch (op >> 5) {
+            case MACRO_OP_PRESS:
+                hold_macro_key(state, (uint16_t)bits << 8 | pgm_read_byte(state->step++));
+                break;
+            case MACRO_OP_RELEASE:
+                release_macro_key(state, (uint16_t)bits << 8 | pgm_read_byte(state->step++));
+                break;
+            case MACRO_OP_TAP:
+                tap_code16((uint16_t)bits << 8 | pgm_read_byte(state->step++));
+                break;
+            case MACRO_OP_DELAY:
+                state->timer = timer_read();
+                state->delay = (uint16_t)bits << 8 | pgm_read_byte(state->step++);
+                return;
+            case MACRO_OP_WRAP:
+                // 5ビットの修飾キー (QK_MODS と同じ形式) を8ビットに変換する
+                bits = bits & 0x10 ? (bits & 0x0F) << 4 : bits;
+                register_mods(bits);
+                state->wrapped_mods |= bits;
+                break;
+            case MACRO_OP_UNWRAP:
+                unregister_mods(state->wrapped_mods);
+                state->wrapped_mods = 0;
+                break;
+            default:
+                // 押したままのキーがあれば離して、キューの次のマクロに進む
+                release_macro_keys(state);
+                state->step = NULL;
+                if (state->queue_count == 0) return;
+                state->step = state->queue[state->queue_head];
+                state->queue_head = (state->queue_head + 1) % MACRO_QUEUE_SIZE;
+                state->queue_count--;
+                break;
+        }
+    }
+}
+
+bool process_macro_keycode(struct MACRO_STATE *state, uint16_t keycode, bool pressed, uint16_t first, const uint8_t *const *table, uint8_t count) {
+    // キーコードの範囲からテーブルを引くだけで、マクロの数によって処理は変わらない (時間は MACRO_BENCHMARK で測る)
+    uint16_t index = keycode - first;
+    if (keycode < first || index >= count) return true;
+    if (pressed) start_macro(state, pgm_read_ptr(&table[index]));
+    return false;
+}
+
+#ifdef MACRO_BENCHMARK
+#include "lib_ion/timer_us.h"
+
+void run_macro_benchmark(struct MACRO_DISPATCH_BENCHMARK *result, struct MACRO_STATE *state, uint16_t first, const uint8_t *const *table, uint8_t count) {
+    // 結果は volatile に書いて、最適化で消えないようにする
+    volatile bool is_other;
+    uint16_t start = read_timer_us();
+    for (uint16_t i = 0; i < MACRO_BENCHMARK; i++) {
+        is_other = process_macro_keycode(state, first + i % count, false, first, table, count);
+    }
+    result->hit_ns = (uint32_t)(uint16_t)(read_timer_us() - start) * 1000 / MACRO_BENCHMARK;
+    start = read_timer_us();
+    for (uint16_t i = 0; i < MACRO_BENCHMARK; i++) {
+        is_other = process_macro_keycode(state, first - 1, true, first, table, count);
+    }
+    result->miss_ns = (uint32_t)(uint16_t)(read_timer_us() - start) * 1000 / MACRO_BENCHMARK;
+    (void)is_other;
+}
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Non-blocking macros: the steps are played from housekeeping_task_user() on timer deadlines,
+// so the matrix scan and the stick keep running while a macro waits.
+
+// What to do when a macro is started while another one is running
+#define MACRO_POLICY_QUEUE 0   // Play after the running and queued macros (dropped when the queue is full)
+#define MACRO_POLICY_REPLACE 1 // Stop the running macro (releasing its keys) and play the new one
+#define MACRO_POLICY_IGNORE 2  // Drop the new macro
+// The defaults below can be changed in the config.h of the keymap
+#ifndef MACRO_CONFLICT_POLICY
+#define MACRO_CONFLICT_POLICY MACRO_POLICY_QUEUE
+#endif
+// Number of the macros waiting in the queue
+#ifndef MACRO_QUEUE_SIZE
+#define MACRO_QUEUE_SIZE 4
+#endif
+// Number of the keys a macro can hold at the same time
+#ifndef MACRO_MAX_HELD
+#define MACRO_MAX_HELD 4
+#endif
+
+// Bytecode: the upper 3 bits of the first byte are the opcode and the lower 5 bits are
+// the modifiers of a 16-bit keycode (same as QK_MODS) or the upper bits of a delay
+enum MACRO_OPCODE {
+    MACRO_OP_END,     // 1 byte
+    MACRO_OP_PRESS,   // 2 bytes: keycode
+    MACRO_OP_RELEASE, // 2 bytes: keycode
+    MACRO_OP_TAP,     // 2 bytes: keycode
+    MACRO_OP_DELAY,   // 2 bytes: 0 - 8191 ms
+    MACRO_OP_WRAP,    // 1 byte: hold the modifiers until MC_UNWRAP or the end of the macro
+    MACRO_OP_UNWRAP,  // 1 byte
+};
+#define MACRO_OP(op, bits) (uint8_t)(((op) << 5) | ((bits) & 0x1F))
+
+// Steps of a macro: static const uint8_t PROGMEM name[] = { ..., MC_END };
+// Keycodes are basic keycodes with optional modifiers, e.g. KC_RPRN or LALT(KC_1)
+#define MC_PRESS(kc) MACRO_OP(MACRO_OP_PRESS, (kc) >> 8), (uint8_t)(kc)
+#define MC_RELEASE(kc) MACRO_OP(MACRO_OP_RELEASE, (kc) >> 8), (uint8_t)(kc)
+#define MC_TAP(kc) MACRO_OP(MACRO_OP_TAP, (kc) >> 8), (uint8_t)(kc)
+#define MC_DELAY(ms) MACRO_OP(MACRO_OP_DELAY, (ms) >> 8), (uint8_t)(ms)
+// mods: MOD_LCTL, MOD_LSFT, MOD_LALT, ... (5-bit)
+#define MC_WRAP(mods) MACRO_OP(MACRO_OP_WRAP, mods)
+#define MC_UNWRAP MACRO_OP(MACRO_OP_UNWRAP, 0)
+#define MC_END MACRO_OP(MACRO_OP_END, 0)
+
+struct MACRO_STATE {
+    const uint8_t *queue[MACRO_QUEUE_SIZE];
+    uint8_t queue_head;
+    uint8_t queue_count;
+    const uint8_t *step; // Next step of the running macro (NULL: not running)
+    uint16_t timer;
+    uint16_t delay;
+    uint8_t wrapped_mods;
+    uint16_t held[MACRO_MAX_HELD];
+};
+
+#define MACRO_INIT {{0}, 0, 0, 0, 0, 0, 0, {0}}
+bool start_macro(struct MACRO_STATE *state, const uint8_t *steps);
+void stop_macros(struct MACRO_STATE *state);
+void run_macros(struct MACRO_STATE *state);
+// Starts table[keycode - first] on press for a keycode in [first, first + count)
+// Returns false when the keycode is a macro, like process_record_user()
+bool process_macro_keycode(struct MACRO_STATE *state, uint16_t keycode, bool pressed, uint16_t first, const uint8_t *const *table, uint8_t count);
+
+#ifdef MACRO_BENCHMARK
+// Time of one process_macro_keycode() (ns) over MACRO_BENCHMARK calls, measured by run_macro_benchmark()
+struct MACRO_DISPATCH_BENCHMARK {
+    uint16_t hit_ns;  // Release of a macro key (in the range of the table, no macro is started)
+    uint16_t miss_ns; // Press of a key before the table (the path of every other key)
+};
+void run_macro_benchmark(struct MACRO_DISPATCH_BENCHMARK *result, struct MACRO_STATE *state, uint16_t first, const uint8_t *const *table, uint8_t count);
+#endif
@@ -1,18 +1,39 @@
 // OLED の描画処理を記述
 #include QMK_KEYBOARD_H
+#include "lib_ion/bitmap.h"
 #include "lib_ion/joystick.h"
+#include "lib_ion/format.h"
+#include "lib_ion/timer_us.h"
 #include "oled.h"
 
+#ifdef OLED_LOGO_BITMAP
+// ページの切り替えで画面を消去したら false に戻して描き直す
+static bool is_logo_drawn = false;
+#endif
+
 void render_logo(void) {
+    #ifdef OLED_LOGO_BITMAP
+    // ロゴは一度だけバッファに書き込み、以降のフレームでは何もしない
+    if (is_logo_drawn) return;
+    render_bitmap_P(lhp_logo_bitmap, 0, 0, LHP_LOGO_BITMAP_WIDTH, LHP_LOGO_BITMAP_PAGES);
+    is_logo_drawn = true;
+    #else
     for (uint8_t i = 0; i < LOGO_LINES; i++) {
         oled_set_cursor(0, i);
         oled_write_P(lhp_logo[i], false);
     }
+    #endif
 };
 
 void render_layer_name(const char* name) {
     oled_write_P(PSTR("Layer: "), false);
+    #ifdef JS_DEBUG_ENABLED
+    // 右下のボックスを消さないように行末ではなくボックスの手前まで空白で埋める
+    oled_write_P(name, false);
+    for (uint8_t i = 7 + strlen_P(name); i < JS_WIDGET_COLUMN; i++) oled_write_char(' ', false);
+    #else
     oled_write_ln_P(name, false);
+    #endif
 }
 
 void render_lock_state(void) {
@@ -29,34 +50,232 @@ void render_js_state(struct JOYSTICK_STATE *js_state, struct JOYSTICK_RAPID_STAT
 }
 
 void render_joystick_angle(int16_t val) {
-    // フラッシュメモリ節約のためsprintfの代わりを自前で実装する
-    char c;
-    bool is_nonzero_printed = false, is_negative = val < 0;
-    if (is_negative) val *= -1;
-    c = (val / 100) + 0x30;
-    if (c != '0') {
-        oled_write_char(is_negative ? '-' : ' ', false);
-        oled_write_char(c, false);
-        is_nonzero_printed = true;
-    } else {
-        oled_write_char(' ', false);
-    }
-    val %= 100;
-    c = (val / 10) + 0x30;
-    if (c != '0') {
-        if (!is_nonzero_printed) oled_write_char(is_negative ? '-' : ' ', false);
-        oled_write_char(c, false);
-        is_nonzero_printed = true;
-    } else {
-        oled_write_char(is_nonzero_printed ? c : ' ', false);
-    }
-    if (!is_nonzero_printed) oled_write_char(is_negative ? '-' : ' ', false);
-    oled_write_char((val % 10) + 0x30, false);
+    char buf[FORMAT_BUFFER_SIZE(4)];
+    FORMAT_INT(buf, val, 4);
+    oled_write(buf, false);
 }
 
 void render_joystick_angles(struct JOYSTICK_STATE *state) {
     oled_write_P(PSTR("X:"), false);
-    render_joystick_angle(state->x);
+    render_joystick_angle(JS_ANGLE_8BIT(state->x));
     oled_write_P(PSTR(" Y:"), false);
-    render_joystick_angle(state->y);
+    render_joystick_angle(JS_ANGLE_8BIT(state->y));
+}
+
+static uint8_t joystick_widget_pos(int16_t val) {
+    // -127 - 127 (8ビットにした値) を枠の内側 1 - (JS_WIDGET_SIZE - 2) に対応させる
+    return (uint16_t)(JS_ANGLE_8BIT(val) + 127) * (JS_WIDGET_SIZE - 3) / (2 * 127) + 1;
+}
+
+static void draw_joystick_widget_box(void) {
+    for (uint8_t i = 0; i < JS_WIDGET_SIZE; i++) {
+        for (uint8_t j = 0; j < JS_WIDGET_SIZE; j++) {
+            bool is_border = i == 0 || j == 0 || i == JS_WIDGET_SIZE - 1 || j == JS_WIDGET_SIZE - 1;
+            oled_write_pixel(JS_WIDGET_X + i, JS_WIDGET_Y + j, is_border);
+        }
+    }
+}
+
+void render_joystick_widget(struct JOYSTICK_WIDGET_STATE *widget, struct JOYSTICK_STATE *state) {
+    uint8_t x = joystick_widget_pos(state->x), y = joystick_widget_pos(state->y);
+    // 枠は最初の1回だけ描画する
+    if (!widget->drawn) {
+        draw_joystick_widget_box();
+        for (uint8_t i = 0; i < JS_WIDGET_TRAIL; i++) {
+            widget->x[i] = x;
+            widget->y[i] = y;
+        }
+        oled_write_pixel(JS_WIDGET_X + x, JS_WIDGET_Y + y, true);
+        widget->drawn = true;
+        return;
+    }
+    if (widget->x[widget->head] == x && widget->y[widget->head] == y) return;
+    // 一番古い点を消して新しい点を描く (フレームあたりの書き込みは高々2ピクセル)
+    uint8_t tail = widget->head + 1 == JS_WIDGET_TRAIL ? 0 : widget->head + 1;
+    bool is_shared = widget->x[tail] == x && widget->y[tail] == y;
+    for (uint8_t i = 0; i < JS_WIDGET_TRAIL && !is_shared; i++) {
+        // 軌跡の他の点と重なっている場合は消さない
+        if (i != tail && widget->x[i] == widget->x[tail] && widget->y[i] == widget->y[tail]) is_shared = true;
+    }
+    if (!is_shared) oled_write_pixel(JS_WIDGET_X + widget->x[tail], JS_WIDGET_Y + widget->y[tail], false);
+    widget->x[tail] = x;
+    widget->y[tail] = y;
+    widget->head = tail;
+    oled_write_pixel(JS_WIDGET_X + x, JS_WIDGET_Y + y, true);
+}
+
+void next_oled_page(struct OLED_PAGE_STATE *state) {
+    state->page = state->page + 1 == OLED_PAGE_COUNT ? 0 : state->page + 1;
+    state->is_changed = true;
+}
+
+bool start_oled_page(struct OLED_PAGE_STATE *state) {
+    // 描画するフレームなら true を返す: 描画途中のフレームがあるか、ページを切り替えた直後か、ページごとの更新間隔が過ぎたとき
+    if (state->is_changed) {
+        // 前のページの描画途中のフレームは捨てて、最初から描く
+        oled_clear();
+        #ifdef OLED_LOGO_BITMAP
+        is_logo_drawn = false;
+        #endif
+        state->is_changed = false;
+        state->is_cleared = true;
+        state->step = 0;
+    } else if (state->step == 0) {
+        if (timer_elapsed(state->timer) < state->periods[state->page]) return false;
+        state->is_cleared = false;
+    }
+    // 更新間隔はフレームを描き始めた時刻から数える
+    if (state->step == 0) state->timer = timer_read();
+    state->slice_step = state->step;
+    state->slice_start = read_timer_us();
+    return true;
+}
+
+uint8_t next_oled_step(struct OLED_PAGE_STATE *state, uint8_t count) {
+    if (state->step >= count) {
+        state->step = 0;
+        return OLED_STEP_NONE;
+    }
+    // 予算を使い切ったら続きは次の呼び出しで描く (進まなくならないように1回に少なくとも1つは描く)
+    if (OLED_FRAME_BUDGET > 0 && state->step != state->slice_step
+        && (uint16_t)(read_timer_us() - state->slice_start) >= OLED_FRAME_BUDGET) return OLED_STEP_NONE;
+    return state->step++;
+}
+
+static void render_latency_histogram(struct SCAN_STATS *stats) {
+    // 3行目: "Lat 0" に続けて LATENCY_BIN_US ごとの棒グラフ (幅5px + 隙間1px), 最後が "875+us"
+    oled_set_cursor(0, 2);
+    oled_write_P(PSTR("Lat 0"), false);
+    uint16_t max = 0;
+    for (uint8_t i = 0; i < LATENCY_BINS; i++) {
+        if (stats->latency[i] > max) max = stats->latency[i];
+    }
+    uint16_t index = 2 * OLED_DISPLAY_WIDTH + 5 * OLED_FONT_WIDTH;
+    for (uint8_t i = 0; i < LATENCY_BINS; i++) {
+        // 最大の棒を 8px として、1回でもあれば 1px 以上にする
+        uint8_t height = max == 0 ? 0 : ((uint32_t)stats->latency[i] * 8 + max - 1) / max;
+        uint8_t bar = (uint8_t)(0xFF00 >> height);
+        for (uint8_t x = 0; x < OLED_FONT_WIDTH; x++) {
+            oled_write_raw_byte(x < OLED_FONT_WIDTH - 1 ? bar : 0, index++);
+        }
+    }
+    char buf[FORMAT_BUFFER_SIZE(4)];
+    FORMAT_UINT(buf, (LATENCY_BINS - 1) * LATENCY_BIN_US, 4);
+    oled_set_cursor(5 + LATENCY_BINS, 2);
+    oled_write(buf, false);
+    oled_write_P(PSTR("+us"), false);
+}
+
+static void render_key_events(struct SCAN_STATS *stats) {
+    // 4行目: 新しい順に3件、"行 列 +/-" と前のイベントからの ms (チャタリングは短い間隔で見える)
+    char buf[FORMAT_BUFFER_SIZE(3)];
+    oled_set_cursor(0, 3);
+    for (uint8_t i = 0; i < 3; i++) {
+        struct KEY_LOG_ENTRY *event = get_key_event(stats, i);
+        if (event == NULL) break;
+        oled_write_char(event->row < 10 ? '0' + event->row : '#', false);
+        oled_write_char(event->col < 10 ? '0' + event->col : '#', false);
+        oled_write_char(event->pressed ? '+' : '-', false);
+        struct KEY_LOG_ENTRY *previous = get_key_event(stats, i + 1);
+        if (previous != NULL) {
+            FORMAT_UINT(buf, TIMER_DIFF_16(event->time, previous->time), 3);
+            oled_write(buf, false);
+        } else {
+            oled_write_P(PSTR("   "), false);
+        }
+        if (i < 2) oled_write_char(' ', false);
+    }
+}
+
+static void render_report_rates(struct SCAN_STATS *stats) {
+    // 1行目: エンドポイントごとの1秒間のレポート数 (キーボード, マウス, ジョイスティック)
+    static const char labels[REPORT_ENDPOINTS] = {'K', 'M', 'J'};
+    char buf[FORMAT_BUFFER_SIZE(4)];
+    oled_set_cursor(0, 0);
+    for (uint8_t i = 0; i < REPORT_ENDPOINTS; i++) {
+        oled_write_char(labels[i], false);
+        FORMAT_UINT(buf, stats->report_rate[i], 4);
+        oled_write(buf, false);
+        oled_write_char(' ', false);
+    }
+    oled_write_P(PSTR("/s"), false);
+}
+
+static void render_scan_rate(struct SCAN_STATS *stats) {
+    // 2行目: 1秒間のスキャン回数と、その間で一番長かったスキャンの間隔 (us)
+    char buf[FORMAT_BUFFER_SIZE(5)];
+    oled_set_cursor(0, 1);
+    oled_write_P(PSTR("S:"), false);
+    FORMAT_UINT(buf, stats->scan_rate, 5);
+    oled_write(buf, false);
+    oled_write_P(PSTR("/s Max:"), false);
+    FORMAT_UINT(buf, stats->max_scan_interval, 5);
+    oled_write(buf, false);
+    oled_write_P(PSTR("us"), false);
+}
+
+void render_stats_page(struct SCAN_STATS *stats, uint8_t step) {
+    // 1行ずつ描く
+    switch (step) {
+        case 0:
+            render_report_rates(stats);
+            break;
+        case 1:
+            render_scan_rate(stats);
+            break;
+        case 2:
+            render_latency_histogram(stats);
+            break;
+        case 3:
+            render_key_events(stats);
+            break;
+    }
+}
+
+void render_calibration_page(struct JOYSTICK_STATE *state, bool is_cleared) {
+    // 調整用に ADC の生の値と、このページを表示してからの最小値・最大値を表示する
+    static const pin_t pins[2] = { JS_PIN_X, JS_PIN_Y };
+    static int16_t mins[2], maxs[2];
+    char buf[FORMAT_BUFFER_SIZE(5)];
+    if (is_cleared) {
+        oled_set_cursor(0, 0);
+        oled_write_P(PSTR("   raw  min  max  mid"), false);
+        oled_set_cursor(0, 3);
+        oled_write_P(PSTR("Deadzone:"), false);
+        FORMAT_UINT(buf, state->profile.deadzone, 5);
+        oled_write(buf, false);
+    }
+    for (uint8_t i = 0; i < 2; i++) {
+        int16_t raw = analogReadPin(pins[i]);
+        if (is_cleared || raw < mins[i]) mins[i] = raw;
+        if (is_cleared || raw > maxs[i]) maxs[i] = raw;
+        oled_set_cursor(0, i + 1);
+        oled_write_char(i == 0 ? 'X' : 'Y', false);
+        FORMAT_INT(buf, raw, 5);
+        oled_write(buf, false);
+        FORMAT_INT(buf, mins[i], 5);
+        oled_write(buf, false);
+        FORMAT_INT(buf, maxs[i], 5);
+        oled_write(buf, false);
+        FORMAT_INT(buf, state->calibration[i].mid, 5);
+        oled_write(buf, false);
+    }
+}
+
+void render_rapid_page(struct JOYSTICK_RAPID_STATE *state) {
+    char buf[FORMAT_BUFFER_SIZE(5)];
+    oled_set_cursor(0, 0);
+    oled_write_P(PSTR("RAPID FIRE"), false);
+    oled_set_cursor(0, 1);
+    oled_write_P(PSTR("State:   "), false);
+    oled_write_P(state->enabled ? PSTR("ON ") : PSTR("OFF"), false);
+    oled_set_cursor(0, 2);
+    oled_write_P(PSTR("Button:"), false);
+    FORMAT_UINT(buf, state->button, 5);
+    oled_write(buf, false);
+    oled_set_cursor(0, 3);
+    oled_write_P(PSTR("Interval:"), false);
+    FORMAT_UINT(buf, state->interval, 5);
+    oled_write(buf, false);
+    oled_write_P(PSTR("ms"), false);
 }
@@ -1,5 +1,64 @@
 #pragma once
 #include "lib_ion/joystick.h"
+#include "lib_ion/stats.h"
+
+// Pages: switched by next_oled_page(), only the visible page is rendered
+enum OLED_PAGE {
+    OLED_PAGE_STATUS,
+    OLED_PAGE_STATS,
+    OLED_PAGE_CALIBRATION,
+    OLED_PAGE_RAPID,
+    OLED_PAGE_COUNT,
+};
+// Refresh period of each page in ms (0: every frame), defaults of OLED_PAGE_STATE.periods
+#define OLED_PAGE_STATUS_PERIOD 0
+#define OLED_PAGE_STATS_PERIOD 500
+#define OLED_PAGE_CALIBRATION_PERIOD 50
+#define OLED_PAGE_RAPID_PERIOD 100
+
+// Time-sliced frames: a page is drawn in small units taken from next_oled_step(). When a call has
+// drawn for OLED_FRAME_BUDGET us, the rest of the frame is drawn by the next calls, so a full redraw
+// (after a page or layer change) is spread over several scans instead of making one scan long.
+// At least one unit is drawn per call; 0 draws every frame at once.
+#ifndef OLED_FRAME_BUDGET
+#define OLED_FRAME_BUDGET 300
+#endif
+// Returned by next_oled_step() when nothing more is drawn in this call
+#define OLED_STEP_NONE 0xFF
+
+struct OLED_PAGE_STATE {
+    uint8_t page;
+    bool is_changed; // The page was switched and the display has to be cleared
+    bool is_cleared; // The display was cleared for this frame and everything has to be drawn again
+    uint8_t step;        // Next unit of the frame being drawn (0: no frame in progress)
+    uint8_t slice_step;  // First unit drawn in this call
+    uint16_t slice_start; // read_timer_us() at the start of this call
+    uint16_t timer;
+    uint16_t periods[OLED_PAGE_COUNT]; // Refresh period of each page (can be changed at runtime by lib_ion/settings.h)
+};
+
+#define OLED_PAGE_PERIODS_DEFAULT {OLED_PAGE_STATUS_PERIOD, OLED_PAGE_STATS_PERIOD, OLED_PAGE_CALIBRATION_PERIOD, OLED_PAGE_RAPID_PERIOD}
+#define OLED_PAGE_INIT {OLED_PAGE_STATUS, true, false, 0, 0, 0, 0, OLED_PAGE_PERIODS_DEFAULT}
+
+// Stick position widget: a box with a cursor dot drawn by pixels
+// Size of the box in pixels (including the border)
+#define JS_WIDGET_SIZE 16
+// Top-left corner of the box (default: bottom-right corner of the display)
+#define JS_WIDGET_X (OLED_DISPLAY_WIDTH - JS_WIDGET_SIZE)
+#define JS_WIDGET_Y (OLED_DISPLAY_HEIGHT - JS_WIDGET_SIZE)
+// Number of the dots kept lit: 1 = cursor only, 2 or more = cursor and trail
+#define JS_WIDGET_TRAIL 1
+// Text columns left of the box (text written over the box would erase it)
+#define JS_WIDGET_COLUMN (JS_WIDGET_X / OLED_FONT_WIDTH)
+
+struct JOYSTICK_WIDGET_STATE {
+    uint8_t x[JS_WIDGET_TRAIL];
+    uint8_t y[JS_WIDGET_TRAIL];
+    uint8_t head;
+    bool drawn;
+};
+
+#define JS_WIDGET_INIT {{0}, {0}, 0, false}
 
 void render_logo(void);
 void render_layer_name(const char* name);
@@ -7,3 +66,18 @@ void render_lock_state(void);
 void render_js_state(struct JOYSTICK_STATE *js_state, struct JOYSTICK_RAPID_STATE *js_rapid_state, bool js_is_mouse);
 void render_joystick_angle(int16_t val);
 void render_joystick_angles(struct JOYSTICK_STATE *angles);
+void render_joystick_widget(struct JOYSTICK_WIDGET_STATE *widget, struct JOYSTICK_STATE *state);
+
+void next_oled_page(struct OLED_PAGE_STATE *state);
+// Returns true when the page is drawn in this call: a frame is in progress, the page was switched,
+// or the refresh period of the page has elapsed
+bool start_oled_page(struct OLED_PAGE_STATE *state);
+// Returns the next unit (0 - count-1) of the frame to draw, or OLED_STEP_NONE when the frame is
+// finished or the budget of this call is used up:
+// for (uint8_t step; (step = next_oled_step(&page, count)) != OLED_STEP_NONE;) render_unit(step);
+uint8_t next_oled_step(struct OLED_PAGE_STATE *state, uint8_t count);
+// Units of the stats page for next_oled_step()
+#define STATS_PAGE_STEPS 4
+void render_stats_page(struct SCAN_STATS *stats, uint8_t step);
+void render_calibration_page(struct JOYSTICK_STATE *state, bool is_cleared);
+void render_rapid_page(struct JOYSTICK_RAPID_STATE *state);
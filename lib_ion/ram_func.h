@@ -0,0 +1,15 @@
+#pragma once
+
+// Functions run from the SRAM instead of the flash (RAM_FUNCS = yes in rules.mk, RP2040 only).
+// The RP2040 reads its code from the QSPI flash through a 16 KB cache (XIP): after the OLED or
+// the USB stack pushed a function out of the cache, its next call waits for the flash line by line,
+// so the run time of the stick and key path depends on what ran before it.
+// ChibiOS copies the .ram0_init sections from the flash to RAM0 at startup, like the initialized data.
+// The calls between the SRAM and the flash are out of the range of BL: the linker adds a long-branch veneer.
+// The QMK and ChibiOS functions they call (analogReadPin, the USB driver) stay in the flash.
+//     RAM_FUNC bool report_joystick(...) { ... }
+#if defined(RAM_FUNCS) && defined(MCU_RP)
+#define RAM_FUNC __attribute__((section(".ram0_init.ion_code")))
+#else
+#define RAM_FUNC
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+
+// Raw HID protocol of lib_ion (host side: lib_ion/tools/ion_hid.py)
+// The host sends a 32-byte report with the command in data[0] and the arguments after it.
+// The keyboard replies with the same report: data[0] is the command (RAWHID_ERROR if unknown)
+// and the result follows. Multi-byte values are little endian.
+#define RAWHID_VERSION 7
+
+enum RAWHID_COMMAND {
+    RAWHID_GET_VERSION = 0x01,    // reply: data[1] = RAWHID_VERSION
+    RAWHID_GET_STATS = 0x02,      // data[1] = page; reply: data[1] = page, data[2..] = dump_scan_stats() (lib_ion/stats.h)
+    RAWHID_TELEMETRY = 0x03,      // data[1] = 1: start or keep alive (within TELEMETRY_TIMEOUT), 0: stop
+    RAWHID_TELEMETRY_DATA = 0x04, // sent by the keyboard: a batch of samples (lib_ion/telemetry.h)
+    RAWHID_SETTINGS_GET = 0x05,   // data[1] = SETTING_ID, data[2] = index (lib_ion/settings.h); reply: data[3..4] = value (int16)
+    RAWHID_SETTINGS_SET = 0x06,   // data[1] = SETTING_ID, data[2] = index, data[3..4] = value; RAWHID_ERROR if out of range
+    RAWHID_SETTINGS_SAVE = 0x07,  // reply: data[1] = 1 if saved to the EEPROM, 0 if the keymap has no EEPROM block
+    RAWHID_SETTINGS_RESET = 0x08, // back to the defaults in RAM (save to clear the EEPROM too)
+    RAWHID_GET_TASK = 0x09,       // data[1] = task index; reply: data[2..] = dump_task() (lib_ion/scheduler.h)
+    RAWHID_ERROR = 0xFF,
+};
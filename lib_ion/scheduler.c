@@ -0,0 +1,57 @@
+// 周期・実行時間の予算・締め切りに遅れた回数を持つタスクの表を、housekeeping_task_user() から順に実行する
+#include QMK_KEYBOARD_H
+#include "lib_ion/ram_func.h"
+#include "lib_ion/scheduler.h"
+#include "lib_ion/timer_us.h"
+
+void init_tasks(struct TASK *tasks, uint8_t count) {
+    uint16_t now = timer_read();
+    for (uint8_t i = 0; i < count; i++) tasks[i].last_run = now;
+}
+
+static RAM_FUNC void run_task(struct TASK *task, uint16_t now) {
+    // 1周期まるごと飛ばしたときだけ数える (ms のタイマーなので1周期未満の遅れは見えない)
+    if (task->period > 0 && TIMER_DIFF_16(now, task->last_run) >= task->period * 2 && task->misses < UINT16_MAX) task->misses++;
+    // 遅れた分を取り戻そうと続けて実行しないように、次の周期は今から数える
+    task->last_run = now;
+    uint16_t start = read_timer_us();
+    task->run();
+    uint16_t time = read_timer_us() - start;
+    if (time > task->max_time) task->max_time = time;
+    if (time > task->budget && task->overruns < UINT16_MAX) task->overruns++;
+}
+
+RAM_FUNC void run_tasks(struct TASK *tasks, uint8_t count) {
+    uint16_t now = timer_read();
+    struct TASK *background = NULL;
+    for (uint8_t i = 0; i < count; i++) {
+        struct TASK *task = &tasks[i];
+        uint16_t elapsed = TIMER_DIFF_16(now, task->last_run);
+        if (elapsed < task->period) continue;
+        if (!task->is_background) {
+            run_task(task, now);
+            continue;
+        }
+        // バックグラウンドのタスクは、実行できるものの中で一番長く待っているものを1つだけ実行する
+        if (background == NULL || elapsed > TIMER_DIFF_16(now, background->last_run)) background = task;
+    }
+    if (background != NULL) run_task(background, now);
+}
+
+static void put_word(uint8_t *data, uint16_t value) {
+    data[0] = value & 0xFF;
+    data[1] = value >> 8;
+}
+
+void dump_task(struct TASK *tasks, uint8_t count, uint8_t index, uint8_t *data, uint8_t length) {
+    memset(data, 0, length);
+    if (length < TASK_DUMP_SIZE) return;
+    data[0] = count;
+    if (index >= count) return;
+    struct TASK *task = &tasks[index];
+    put_word(&data[1], task->period);
+    put_word(&data[3], task->budget);
+    put_word(&data[5], task->misses);
+    put_word(&data[7], task->overruns);
+    put_word(&data[9], task->max_time);
+}
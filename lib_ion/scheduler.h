@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Cooperative scheduler: a static table of tasks run from housekeeping_task_user() by run_tasks().
+// A task runs when its period has elapsed. The foreground tasks run in the order of the table,
+// then at most one background task: the one waiting the longest, so they take turns and a heavy
+// job (the OLED) delays the next stick sample by one run at most, not by all of the background jobs.
+// Every run is timed: a run longer than the budget is an overrun, and a task that starts a whole
+// period late (another task or QMK took the time) is a deadline miss.
+
+struct TASK {
+    void (*run)(void);
+    uint16_t period;    // ms between the runs (0: every call)
+    uint16_t budget;    // us a run should take
+    bool is_background; // One background task runs per call, after the foreground ones
+    uint16_t last_run;  // timer_read() at the last run
+    uint16_t misses;    // Runs started a whole period late (or later)
+    uint16_t overruns;  // Runs longer than the budget
+    uint16_t max_time;  // Longest run (us)
+};
+
+// static struct TASK tasks[] = { TASK(run_stick, 1, 300, false), ... };
+#define TASK(run, period, budget, is_background) {run, period, budget, is_background, 0, 0, 0, 0}
+// Budget of a task not measured on the board yet: no overruns are counted, max_time is still recorded.
+// Set the budget from the max_time of `ion_hid.py tasks` (lib_ion/tools) with some margin.
+#define TASK_BUDGET_UNMEASURED UINT16_MAX
+// Called from keyboard_post_init_user(): the periods start now, not at power on
+void init_tasks(struct TASK *tasks, uint8_t count);
+// Called from housekeeping_task_user()
+void run_tasks(struct TASK *tasks, uint8_t count);
+
+// Dump for raw HID (see lib_ion/rawhid.h), little endian:
+// number of the tasks (1), then task index: period, budget, misses, overruns, max_time (2 each)
+#define TASK_DUMP_SIZE 11
+void dump_task(struct TASK *tasks, uint8_t count, uint8_t index, uint8_t *data, uint8_t length);
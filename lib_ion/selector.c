@@ -0,0 +1,51 @@
+// スティックのボタンを押したまま上下に倒してジョブ (レイヤー) を選び、離したときに切り替える
+#include QMK_KEYBOARD_H
+#include "lib_ion/selector.h"
+
+void press_layer_selector(struct LAYER_SELECTOR_STATE *state, bool pressed, uint8_t layer) {
+    if (pressed) {
+        state->held = true;
+        state->active = false;
+        state->layer = layer < state->count ? layer : 0;
+        state->dir = 0;
+        return;
+    }
+    state->held = false;
+    if (!state->active) return;
+    // 倒さずに離したときは普通のボタンとして扱い、レイヤーは変えない
+    state->active = false;
+    layer_move(state->layer);
+}
+
+void run_layer_selector(struct LAYER_SELECTOR_STATE *state, int16_t y) {
+    if (!state->held) return;
+    int8_t dir = y < -LAYER_SELECTOR_THRESHOLD ? -1 : y > LAYER_SELECTOR_THRESHOLD ? 1 : 0;
+    if (dir == 0) {
+        state->dir = 0;
+        return;
+    }
+    // 倒したままのときは一定の間隔で送る
+    if (dir == state->dir && timer_elapsed(state->timer) < LAYER_SELECTOR_REPEAT) return;
+    if (!state->active) {
+        // 選択中はボタンを押していないことにする
+        state->active = true;
+        unregister_joystick_button(LAYER_SELECTOR_BUTTON);
+    }
+    state->layer = (state->layer + state->count + dir) % state->count;
+    state->dir = dir;
+    state->timer = timer_read();
+    state->is_changed = true;
+}
+
+void render_layer_selector(struct LAYER_SELECTOR_STATE *state, const char (*names)[LAYER_NAME_SIZE]) {
+    if (!state->is_changed) return;
+    state->is_changed = false;
+    // 選択中のレイヤーを2行目に、前後のレイヤーを上下に表示する (最後の次は最初に戻る)
+    for (uint8_t row = 0; row < 4; row++) {
+        uint8_t layer = (state->layer + state->count + row - 1) % state->count;
+        oled_set_cursor(0, row);
+        oled_write_P(row == 1 ? PSTR("> ") : PSTR("  "), false);
+        oled_write_P(names[layer], row == 1);
+        oled_advance_page(true);
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Layer (job) selector: hold the stick button and tilt up/down to scroll the layer names,
+// then release the button to jump to the highlighted layer
+
+// Size of a layer name including '\0' (one line of the 128px OLED with "> ")
+#define LAYER_NAME_SIZE 14
+// Tilt (of JOYSTICK_MAX_VALUE) to scroll
+#define LAYER_SELECTOR_THRESHOLD (JOYSTICK_MAX_VALUE / 2)
+// Interval of scrolling while the stick is kept tilted
+#define LAYER_SELECTOR_REPEAT 150
+// Joystick button released to the host while selecting (the button of JS_0)
+#define LAYER_SELECTOR_BUTTON 0
+
+struct LAYER_SELECTOR_STATE {
+    uint8_t count;   // Number of the layers (names)
+    uint8_t layer;   // Highlighted layer
+    bool held;       // The button is held
+    bool active;     // Tilted while the button is held: the menu is shown
+    bool is_changed; // The menu has to be drawn
+    int8_t dir;      // -1: up, 1: down, 0: center
+    uint16_t timer;
+};
+
+#define LAYER_SELECTOR_INIT(count) {count, 0, false, false, false, 0, 0}
+// Call on press/release of the button with the current layer
+void press_layer_selector(struct LAYER_SELECTOR_STATE *state, bool pressed, uint8_t layer);
+// Call from matrix_scan_user() with the stick (y: negative is up)
+void run_layer_selector(struct LAYER_SELECTOR_STATE *state, int16_t y);
+// Draws the menu on the 4 lines of the OLED when it is changed
+void render_layer_selector(struct LAYER_SELECTOR_STATE *state, const char (*names)[LAYER_NAME_SIZE]);
@@ -0,0 +1,174 @@
+// 実行中に変更できる設定 (スティックのプロファイル・キャリブレーション・OLED の更新間隔) と Raw HID のコマンド
+#include QMK_KEYBOARD_H
+#include "lib_ion/rawhid.h"
+#include "lib_ion/settings.h"
+
+#if (EECONFIG_USER_DATA_SIZE) > 0
+_Static_assert(sizeof(struct SETTINGS) <= (EECONFIG_USER_DATA_SIZE), "EECONFIG_USER_DATA_SIZE is too small for struct SETTINGS");
+#endif
+
+// 設定できる範囲 (Raw HID からの変更と、EEPROM から読んだ値の確認で同じものを使う)
+#define RAPID_INTERVAL_MAX 10000
+#define MOUSE_SPEED_MAX 127
+#define OLED_PERIOD_MAX 10000
+
+static const struct JOYSTICK_AXIS_CALIBRATION PROGMEM default_calibration[2] = JS_CALIBRATION_DEFAULT;
+static const uint16_t PROGMEM default_oled_periods[OLED_PAGE_COUNT] = OLED_PAGE_PERIODS_DEFAULT;
+
+static void reset_settings(struct SETTINGS_STATE *state) {
+    struct SETTINGS *values = &state->values;
+    values->version = SETTINGS_VERSION;
+    for (uint8_t i = 0; i < SETTINGS_PROFILE_COUNT; i++) {
+        uint8_t layer = i < state->default_profile_count ? i : 0;
+        memcpy_P(&values->profiles[i], &state->default_profiles[layer], sizeof(struct JOYSTICK_PROFILE));
+    }
+    memcpy_P(values->calibration, default_calibration, sizeof(values->calibration));
+    memcpy_P(values->oled_periods, default_oled_periods, sizeof(values->oled_periods));
+}
+
+static bool check_settings(struct SETTINGS *values) {
+    // EEPROM の値は壊れているかもしれないので、Raw HID からの変更と同じ範囲を確かめる
+    // 事前に計算しておく値は保存されたものを使わずに計算し直す
+    for (uint8_t i = 0; i < SETTINGS_PROFILE_COUNT; i++) {
+        struct JOYSTICK_PROFILE *profile = &values->profiles[i];
+        // bool に 0, 1 以外が入っていてもわかるようにバイトとして読む
+        if (*(const uint8_t *)&profile->is_mouse > 1 || profile->curve > JS_CURVE_QUADRATIC || profile->deadzone > JS_ADC_MAX) return false;
+        if (profile->rapid_interval < 1 || profile->rapid_interval > RAPID_INTERVAL_MAX) return false;
+        if (profile->mouse_speed < 1 || profile->mouse_speed > MOUSE_SPEED_MAX) return false;
+        update_joystick_profile(profile);
+    }
+    for (uint8_t axis = 0; axis < 2; axis++) {
+        struct JOYSTICK_AXIS_CALIBRATION *calibration = &values->calibration[axis];
+        int16_t points[3] = {calibration->low, calibration->mid, calibration->high};
+        for (uint8_t i = 0; i < 3; i++) {
+            if (points[i] < 0 || points[i] > JS_ADC_MAX) return false;
+        }
+        if (!set_joystick_calibration(calibration, points[0], points[1], points[2])) return false;
+    }
+    for (uint8_t i = 0; i < OLED_PAGE_COUNT; i++) {
+        if (values->oled_periods[i] > OLED_PERIOD_MAX) return false;
+    }
+    return true;
+}
+
+void load_settings(struct SETTINGS_STATE *state) {
+    reset_settings(state);
+    #if (EECONFIG_USER_DATA_SIZE) > 0
+    if (!eeconfig_is_user_datablock_valid()) return;
+    struct SETTINGS saved;
+    eeconfig_read_user_datablock(&saved, 0, sizeof(saved));
+    // 古い版や範囲外の値があれば、全て初期値のままにする
+    if (saved.version != SETTINGS_VERSION || !check_settings(&saved)) return;
+    state->values = saved;
+    #endif
+}
+
+void apply_settings(struct SETTINGS_STATE *state, struct JOYSTICK_STATE *js_state, struct JOYSTICK_RAPID_STATE *rapid_state, struct OLED_PAGE_STATE *oled_page, uint8_t layer) {
+    struct SETTINGS *values = &state->values;
+    set_joystick_profile(js_state, rapid_state, &values->profiles[layer < SETTINGS_PROFILE_COUNT ? layer : 0]);
+    memcpy(js_state->calibration, values->calibration, sizeof(js_state->calibration));
+    memcpy(oled_page->periods, values->oled_periods, sizeof(oled_page->periods));
+}
+
+static bool get_setting(struct SETTINGS *values, uint8_t id, uint8_t index, int16_t *value) {
+    if (id < SETTING_CALIBRATION && index >= SETTINGS_PROFILE_COUNT) return false;
+    struct JOYSTICK_PROFILE *profile = &values->profiles[index < SETTINGS_PROFILE_COUNT ? index : 0];
+    switch (id) {
+        case SETTING_MOUSE:
+            *value = profile->is_mouse;
+            return true;
+        case SETTING_CURVE:
+            *value = profile->curve;
+            return true;
+        case SETTING_DEADZONE:
+            *value = profile->deadzone;
+            return true;
+        case SETTING_RAPID_INTERVAL:
+            *value = profile->rapid_interval;
+            return true;
+        case SETTING_MOUSE_SPEED:
+            *value = profile->mouse_speed;
+            return true;
+        case SETTING_CALIBRATION: {
+            if (index >= 6) return false;
+            struct JOYSTICK_AXIS_CALIBRATION *calibration = &values->calibration[index / 3];
+            *value = index % 3 == 0 ? calibration->low : index % 3 == 1 ? calibration->mid : calibration->high;
+            return true;
+        }
+        case SETTING_OLED_PERIOD:
+            if (index >= OLED_PAGE_COUNT) return false;
+            *value = values->oled_periods[index];
+            return true;
+    }
+    return false;
+}
+
+static bool set_setting(struct SETTINGS *values, uint8_t id, uint8_t index, int16_t value) {
+    // 範囲外の値は受け付けず、事前に計算しておく値はここで一度だけ計算する
+    if (id < SETTING_CALIBRATION && index >= SETTINGS_PROFILE_COUNT) return false;
+    struct JOYSTICK_PROFILE *profile = &values->profiles[index < SETTINGS_PROFILE_COUNT ? index : 0];
+    switch (id) {
+        case SETTING_MOUSE:
+            if (value < 0 || value > 1) return false;
+            profile->is_mouse = value;
+            return true;
+        case SETTING_CURVE:
+            if (value < JS_CURVE_LINEAR || value > JS_CURVE_QUADRATIC) return false;
+            profile->curve = value;
+            return true;
+        case SETTING_DEADZONE:
+            if (value < 0 || value > JS_ADC_MAX) return false;
+            profile->deadzone = value;
+            update_joystick_profile(profile);
+            return true;
+        case SETTING_RAPID_INTERVAL:
+            if (value < 1 || value > RAPID_INTERVAL_MAX) return false;
+            profile->rapid_interval = value;
+            return true;
+        case SETTING_MOUSE_SPEED:
+            if (value < 1 || value > MOUSE_SPEED_MAX) return false;
+            profile->mouse_speed = value;
+            update_joystick_profile(profile);
+            return true;
+        case SETTING_CALIBRATION: {
+            if (index >= 6 || value < 0 || value > JS_ADC_MAX) return false;
+            struct JOYSTICK_AXIS_CALIBRATION *calibration = &values->calibration[index / 3];
+            int16_t points[3] = {calibration->low, calibration->mid, calibration->high};
+            points[index % 3] = value;
+            return set_joystick_calibration(calibration, points[0], points[1], points[2]);
+        }
+        case SETTING_OLED_PERIOD:
+            if (index >= OLED_PAGE_COUNT || value < 0 || value > OLED_PERIOD_MAX) return false;
+            values->oled_periods[index] = value;
+            return true;
+    }
+    return false;
+}
+
+bool process_settings_command(struct SETTINGS_STATE *state, uint8_t *data) {
+    int16_t value;
+    switch (data[0]) {
+        case RAWHID_SETTINGS_GET:
+            if (!get_setting(&state->values, data[1], data[2], &value)) break;
+            data[3] = value & 0xFF;
+            data[4] = (uint16_t)value >> 8;
+            return false;
+        case RAWHID_SETTINGS_SET:
+            value = data[3] | (data[4] << 8);
+            if (!set_setting(&state->values, data[1], data[2], value)) break;
+            return true;
+        case RAWHID_SETTINGS_SAVE:
+            #if (EECONFIG_USER_DATA_SIZE) > 0
+            eeconfig_update_user_datablock(&state->values, 0, sizeof(state->values));
+            data[1] = 1;
+            #else
+            data[1] = 0;
+            #endif
+            return false;
+        case RAWHID_SETTINGS_RESET:
+            reset_settings(state);
+            return true;
+    }
+    data[0] = RAWHID_ERROR;
+    return false;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "lib_ion/joystick.h"
+#include "lib_ion/oled.h"
+
+// Runtime settings: the stick profiles of the layers, the calibration and the OLED refresh periods
+// are kept in a RAM block that the host reads and writes over raw HID (lib_ion/rawhid.h).
+// Setting a value recomputes its precomputed values once; the matrix scan only reads the copies
+// that apply_settings() puts into the keymap's states. The block can be saved to the EEPROM
+// (EECONFIG_USER_DATA_SIZE in the keymap's config.h) and is loaded from it at startup.
+
+// Incremented when the layout or the meaning of struct SETTINGS changes: an old block in the EEPROM is ignored
+// 2: calibration scales with JS_ANGLE_SHIFT = 32 - JOYSTICK_AXIS_RESOLUTION
+#define SETTINGS_VERSION 2
+// Number of the layers with their own stick profile (the layers after them use the first one)
+#ifndef SETTINGS_PROFILE_COUNT
+#define SETTINGS_PROFILE_COUNT 4
+#endif
+
+// Parameters: data[1] of RAWHID_SETTINGS_GET / RAWHID_SETTINGS_SET, with an index in data[2]
+enum SETTING_ID {
+    SETTING_MOUSE = 0x01,          // index: layer, 0: gamepad, 1: mouse
+    SETTING_CURVE = 0x02,          // index: layer, JS_CURVE_*
+    SETTING_DEADZONE = 0x03,       // index: layer, 0 - JS_ADC_MAX
+    SETTING_RAPID_INTERVAL = 0x04, // index: layer, 1 - 10000 ms
+    SETTING_MOUSE_SPEED = 0x05,    // index: layer, 1 (fastest) - 127 (slowest)
+    SETTING_CALIBRATION = 0x10,    // index: axis * 3 + (0: low, 1: mid, 2: high), 0 - JS_ADC_MAX
+    SETTING_OLED_PERIOD = 0x20,    // index: OLED page, 0 - 10000 ms
+};
+
+// The block saved to the EEPROM
+struct SETTINGS {
+    uint8_t version;
+    struct JOYSTICK_PROFILE profiles[SETTINGS_PROFILE_COUNT];
+    struct JOYSTICK_AXIS_CALIBRATION calibration[2];
+    uint16_t oled_periods[OLED_PAGE_COUNT];
+};
+
+struct SETTINGS_STATE {
+    const struct JOYSTICK_PROFILE *default_profiles; // PROGMEM table of the keymap, used by reset
+    uint8_t default_profile_count;
+    struct SETTINGS values;
+};
+
+#define SETTINGS_INIT(profiles) {profiles, ARRAY_SIZE(profiles), {0}}
+// Called from keyboard_post_init_user(): the defaults, then the EEPROM if a block of this version is saved
+// and all of its values are in range (the precomputed values are computed again, not read)
+void load_settings(struct SETTINGS_STATE *state);
+// Copies the settings into the states used by the matrix scan (after load or a change, and on a layer change)
+void apply_settings(struct SETTINGS_STATE *state, struct JOYSTICK_STATE *js_state, struct JOYSTICK_RAPID_STATE *rapid_state, struct OLED_PAGE_STATE *oled_page, uint8_t layer);
+// Handles RAWHID_SETTINGS_* from raw_hid_receive() and writes the reply into data.
+// Returns true when the settings were changed and have to be applied.
+bool process_settings_command(struct SETTINGS_STATE *state, uint8_t *data);
@@ -0,0 +1,134 @@
+// 性能計測用のカウンタ
+#include QMK_KEYBOARD_H
+#include "host.h"
+#include "lib_ion/stats.h"
+#include "lib_ion/timer_us.h"
+
+_Static_assert((KEY_EVENT_LOG_SIZE & (KEY_EVENT_LOG_SIZE - 1)) == 0, "KEY_EVENT_LOG_SIZE must be a power of 2");
+
+// ホストのドライバには状態を渡せないので、差し替えたときの SCAN_STATS を覚えておく
+static struct SCAN_STATS *counted_stats;
+static host_driver_t *original_driver;
+static host_driver_t counting_driver;
+
+static void counting_send_keyboard(report_keyboard_t *report) {
+    counted_stats->reports[REPORT_KEYBOARD]++;
+    original_driver->send_keyboard(report);
+}
+
+static void counting_send_nkro(report_nkro_t *report) {
+    counted_stats->reports[REPORT_KEYBOARD]++;
+    original_driver->send_nkro(report);
+}
+
+static void counting_send_mouse(report_mouse_t *report) {
+    counted_stats->reports[REPORT_MOUSE]++;
+    original_driver->send_mouse(report);
+}
+
+static void hook_host_driver(struct SCAN_STATS *stats) {
+    // QMK はキーボードの初期化 (keyboard_post_init_user) の後でドライバを設定するので、スキャンのたびに確かめる
+    host_driver_t *driver = host_get_driver();
+    if (driver == NULL || driver == &counting_driver) return;
+    counted_stats = stats;
+    original_driver = driver;
+    counting_driver = *driver;
+    counting_driver.send_keyboard = counting_send_keyboard;
+    counting_driver.send_nkro = counting_send_nkro;
+    counting_driver.send_mouse = counting_send_mouse;
+    host_set_driver(&counting_driver);
+}
+
+void count_report(struct SCAN_STATS *stats, uint8_t endpoint) {
+    stats->reports[endpoint]++;
+}
+
+void count_scan(struct SCAN_STATS *stats) {
+    hook_host_driver(stats);
+    stats->scan_time = timer_read();
+    // スキャンの間隔はループ全体 (キーの処理, タスク, OLED の転送) の時間になる
+    // matrix_scan_user() はキーのイベントを処理する前に呼ばれるので、直前のスキャンの時刻が変化の起きた時刻の下限になる
+    uint16_t now_us = read_timer_us();
+    if (!stats->is_started) {
+        // init_tasks() と同じく、1秒の区間と間隔は最初のスキャンから数える (電源を入れてからの時間や 0us からの間隔を数えない)
+        stats->is_started = true;
+        stats->timer = stats->scan_time;
+        stats->previous_scan_us = stats->scan_us = now_us;
+        return;
+    }
+    stats->scans++;
+    uint16_t interval = now_us - stats->scan_us;
+    stats->previous_scan_us = stats->scan_us;
+    stats->scan_us = now_us;
+    if (interval > stats->max_interval) stats->max_interval = interval;
+    if (TIMER_DIFF_16(stats->scan_time, stats->timer) < 1000) return;
+    stats->scan_rate = stats->scans;
+    stats->scans = 0;
+    stats->max_scan_interval = stats->max_interval;
+    stats->max_interval = 0;
+    for (uint8_t i = 0; i < REPORT_ENDPOINTS; i++) {
+        stats->report_rate[i] = stats->reports[i];
+        stats->reports[i] = 0;
+    }
+    // 処理の遅れで計測の区間がずれないように timer_read() ではなく1秒ずつ進める
+    stats->timer += 1000;
+}
+
+void log_key_event(struct SCAN_STATS *stats, keyrecord_t *record) {
+    if (!IS_KEYEVENT(record->event)) return;
+    struct KEY_LOG_ENTRY *event = &stats->events[stats->event_head];
+    event->time = record->event.time;
+    event->row = record->event.key.row;
+    event->col = record->event.key.col;
+    event->pressed = record->event.pressed;
+    stats->event_head = (stats->event_head + 1) & (KEY_EVENT_LOG_SIZE - 1);
+    if (stats->event_count < KEY_EVENT_LOG_SIZE) stats->event_count++;
+}
+
+void count_key_latency(struct SCAN_STATS *stats, keyrecord_t *record) {
+    if (!IS_KEYEVENT(record->event) || !record->event.pressed) return;
+    // 直前のスキャンからレポートを送り終えるまでの us (スキャンの間隔の分だけ多めに見積もる)
+    uint16_t latency = read_timer_us() - stats->previous_scan_us;
+    // 除算を使わずに LATENCY_BIN_US ごとに数える
+    uint8_t bin = 0;
+    for (uint16_t limit = LATENCY_BIN_US; bin < LATENCY_BINS - 1 && latency >= limit; limit += LATENCY_BIN_US) bin++;
+    if (stats->latency[bin] < UINT16_MAX) stats->latency[bin]++;
+}
+
+struct KEY_LOG_ENTRY *get_key_event(struct SCAN_STATS *stats, uint8_t n) {
+    if (n >= stats->event_count) return NULL;
+    return &stats->events[(stats->event_head - 1 - n) & (KEY_EVENT_LOG_SIZE - 1)];
+}
+
+static void put_word(uint8_t *data, uint16_t value) {
+    data[0] = value & 0xFF;
+    data[1] = value >> 8;
+}
+
+void dump_scan_stats(struct SCAN_STATS *stats, uint8_t page, uint8_t *data, uint8_t length) {
+    memset(data, 0, length);
+    if (page == 0) {
+        if (length < 8 + LATENCY_BINS * 2 + REPORT_ENDPOINTS * 2) return;
+        put_word(data, stats->scan_rate);
+        data[2] = LATENCY_BINS;
+        data[3] = KEY_EVENT_LOG_SIZE;
+        data[4] = stats->event_count;
+        for (uint8_t i = 0; i < LATENCY_BINS; i++) put_word(&data[5 + i * 2], stats->latency[i]);
+        uint8_t *rates = &data[5 + LATENCY_BINS * 2];
+        rates[0] = REPORT_ENDPOINTS;
+        for (uint8_t i = 0; i < REPORT_ENDPOINTS; i++) put_word(&rates[1 + i * 2], stats->report_rate[i]);
+        put_word(&rates[1 + REPORT_ENDPOINTS * 2], stats->max_scan_interval);
+        return;
+    }
+    // 古い順に並べる
+    uint8_t first = (page - 1) * KEY_EVENT_DUMP_PER_PAGE;
+    for (uint8_t i = 0; i < KEY_EVENT_DUMP_PER_PAGE && (i + 1) * KEY_EVENT_DUMP_SIZE <= length; i++) {
+        if (first + i >= stats->event_count) return;
+        struct KEY_LOG_ENTRY *event = get_key_event(stats, stats->event_count - 1 - (first + i));
+        uint8_t *p = &data[i * KEY_EVENT_DUMP_SIZE];
+        put_word(p, event->time);
+        p[2] = event->row;
+        p[3] = event->col;
+        p[4] = event->pressed;
+    }
+}
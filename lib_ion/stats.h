@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Number of the recent key events kept in the ring (a power of 2)
+#ifndef KEY_EVENT_LOG_SIZE
+#define KEY_EVENT_LOG_SIZE 8
+#endif
+// Latency histogram: one bin per LATENCY_BIN_US, the last bin also counts everything longer
+#define LATENCY_BINS 8
+#define LATENCY_BIN_US 125
+
+// HID reports counted per endpoint (the raw HID replies are not counted).
+// The keyboard and mouse reports are counted in the host driver, which count_scan() wraps;
+// QMK sends the joystick report outside the driver, so the keymap counts it with count_report().
+enum REPORT_ENDPOINT {
+    REPORT_KEYBOARD, // keyboard and NKRO
+    REPORT_MOUSE,
+    REPORT_JOYSTICK,
+    REPORT_ENDPOINTS,
+};
+
+struct KEY_LOG_ENTRY {
+    uint16_t time;  // record->event.time (ms)
+    uint8_t row;
+    uint8_t col;
+    bool pressed;
+};
+
+// Performance counters shown on the OLED stats page
+struct SCAN_STATS {
+    uint16_t scans;      // matrix scans in the current second
+    uint16_t scan_rate;  // matrix scans in the last second
+    uint16_t timer;
+    uint16_t scan_time;  // time of the latest scan (ms)
+    struct KEY_LOG_ENTRY events[KEY_EVENT_LOG_SIZE];
+    uint8_t event_head;   // index to write the next event
+    uint8_t event_count;  // number of the events in the ring (up to KEY_EVENT_LOG_SIZE)
+    uint16_t latency[LATENCY_BINS];  // number of the presses by LATENCY_BIN_US from the matrix change to the HID report
+    uint16_t reports[REPORT_ENDPOINTS];      // reports sent in the current second
+    uint16_t report_rate[REPORT_ENDPOINTS];  // reports sent in the last second
+    uint16_t scan_us;            // read_timer_us() at the latest scan
+    uint16_t previous_scan_us;   // read_timer_us() at the scan before it (a key seen in the latest scan changed after this)
+    uint16_t max_interval;       // longest interval between two scans in the current second (us)
+    uint16_t max_scan_interval;  // longest interval between two scans in the last second (us)
+    bool is_started;             // The first scan started the window of timer and the intervals
+};
+
+#define SCAN_STATS_INIT {0, 0, 0, 0, {{0}}, 0, 0, {0}, {0}, {0}, 0, 0, 0, 0, false}
+// Called from matrix_scan_user() (also installs the counting host driver once QMK has set it up)
+void count_scan(struct SCAN_STATS *stats);
+// Called by the keymap after it sent a report of the endpoint itself (REPORT_JOYSTICK)
+void count_report(struct SCAN_STATS *stats, uint8_t endpoint);
+// Called at the beginning of process_record_user() (every key event, even the ones the keymap handles)
+void log_key_event(struct SCAN_STATS *stats, keyrecord_t *record);
+// Called from post_process_record_user(), after the report of the key was sent
+void count_key_latency(struct SCAN_STATS *stats, keyrecord_t *record);
+// Returns the n-th latest event (0: latest), NULL if there is none
+struct KEY_LOG_ENTRY *get_key_event(struct SCAN_STATS *stats, uint8_t n);
+
+// Dump for raw HID (see lib_ion/rawhid.h), little endian
+// page 0: scan_rate (2), LATENCY_BINS (1), KEY_EVENT_LOG_SIZE (1), event_count (1), latency (2 each, LATENCY_BIN_US per bin),
+//         REPORT_ENDPOINTS (1), report_rate (2 each), max_scan_interval (2)
+// page 1 and after: KEY_EVENT_DUMP_PER_PAGE events from the oldest, time (2), row (1), col (1), pressed (1) each
+#define KEY_EVENT_DUMP_SIZE 5
+#define KEY_EVENT_DUMP_PER_PAGE 6
+void dump_scan_stats(struct SCAN_STATS *stats, uint8_t page, uint8_t *data, uint8_t length);
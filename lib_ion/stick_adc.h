@@ -0,0 +1,16 @@
+#pragma once
+
+// Native resolution of the stick ADC: 10 bits on the atmega32u4, 12 bits on the RP2040.
+// On ChibiOS QMK reads 10 bits unless ADC_RESOLUTION is set, so the RP2040 boards set 12 in config.h.
+#if defined(__AVR__)
+#define JS_ADC_BITS 10
+#elif defined(ADC_RESOLUTION)
+#define JS_ADC_BITS ADC_RESOLUTION
+#else
+#define JS_ADC_BITS 10
+#endif
+#define JS_ADC_MAX ((1 << JS_ADC_BITS) - 1)
+#define JS_ADC_CENTER (1 << (JS_ADC_BITS - 1))
+
+// A value written for 10 bits (the calibrations measured on the atmega32u4 boards) at the native resolution
+#define JS_ADC_10BIT(val) ((val) << (JS_ADC_BITS - 10))
@@ -0,0 +1,64 @@
+// Raw HID でスティックの生の値・出力値・スキャン間隔をまとめて PC に送る
+#include QMK_KEYBOARD_H
+#include "raw_hid.h"
+#include "lib_ion/joystick.h"
+#include "lib_ion/rawhid.h"
+#include "lib_ion/telemetry.h"
+#include "lib_ion/timer_us.h"
+
+_Static_assert(TELEMETRY_SAMPLES >= 1, "TELEMETRY_REPORT_SIZE is too small");
+
+static void put_word(uint8_t *data, uint16_t value) {
+    data[0] = value & 0xFF;
+    data[1] = value >> 8;
+}
+
+void set_telemetry(struct TELEMETRY_STATE *state, bool active) {
+    if (active && !state->active) {
+        state->count = 0;
+        state->is_queued = false;
+        state->last_us = read_timer_us();
+    }
+    state->active = active;
+    state->timer = timer_read();
+}
+
+void run_telemetry(struct TELEMETRY_STATE *state, struct JOYSTICK_STATE *js_state) {
+    if (!state->active) return;
+    if (timer_elapsed(state->timer) > TELEMETRY_TIMEOUT) {
+        state->active = false;
+        return;
+    }
+    uint16_t now = read_timer_us();
+    if (state->count == 0) state->batch_us = state->last_us;
+    uint8_t *report = state->reports[state->filling];
+    uint8_t *p = &report[TELEMETRY_HEADER_SIZE + state->count * TELEMETRY_SAMPLE_SIZE];
+    // 12ビットずつ3バイトに詰める
+    p[0] = js_state->raw.x & 0xFF;
+    p[1] = ((js_state->raw.x >> 8) & 0x0F) | ((js_state->raw.y & 0x0F) << 4);
+    p[2] = (js_state->raw.y >> 4) & 0xFF;
+    put_word(&p[3], js_state->x);
+    put_word(&p[5], js_state->y);
+    put_word(&p[7], now - state->last_us);
+    state->last_us = now;
+    if (++state->count < TELEMETRY_SAMPLES) return;
+    report[0] = RAWHID_TELEMETRY_DATA;
+    report[1] = state->seq++;
+    report[2] = state->count;
+    state->count = 0;
+    // 送信はホストのポーリングを待つので、ここでは送らずにバックグラウンドのタスクに渡す
+    // 前のレポートがまだ送られていなければ、このレポートは捨てて同じ場所にまた詰める (番号が飛ぶ)
+    // 次のサンプルの間隔は捨てたレポートの前から数えるので、PC で足し合わせた時刻はずれない
+    if (state->is_queued) {
+        state->last_us = state->batch_us;
+        return;
+    }
+    state->is_queued = true;
+    state->filling ^= 1;
+}
+
+void send_telemetry(struct TELEMETRY_STATE *state) {
+    if (!state->is_queued) return;
+    raw_hid_send(state->reports[state->filling ^ 1], TELEMETRY_REPORT_SIZE);
+    state->is_queued = false;
+}
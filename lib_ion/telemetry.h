@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Raw HID telemetry: every call of run_telemetry() adds a sample of the stick, and full batches are sent as
+// RAWHID_TELEMETRY_DATA reports (lib_ion/rawhid.h) while the host keeps the stream alive.
+// Sending waits for the host to poll, so run_telemetry() only queues a full batch and send_telemetry(),
+// run as a background task, sends it: the wait does not count in the time of the stick sampling.
+// One batch waits at most; a batch completed while the previous one is still queued is dropped
+// (the host sees it as a gap of the sequence number, and the next sample counts its time from the batch
+// before it, so the time stays right). The stream stops by itself when the host goes away.
+
+#define TELEMETRY_REPORT_SIZE 32
+// Header of a report: command, sequence number, number of samples
+#define TELEMETRY_HEADER_SIZE 3
+// Sample: raw X and Y (12 bits each, 3 bytes), output X and Y (int16 each), us since the previous sample (uint16)
+#define TELEMETRY_SAMPLE_SIZE 9
+#define TELEMETRY_SAMPLES ((TELEMETRY_REPORT_SIZE - TELEMETRY_HEADER_SIZE) / TELEMETRY_SAMPLE_SIZE)
+// The stream stops when the host has not sent RAWHID_TELEMETRY for this time (ms)
+#define TELEMETRY_TIMEOUT 2000
+
+struct TELEMETRY_STATE {
+    bool active;
+    bool is_queued;    // The report not being filled holds a full batch for send_telemetry()
+    uint16_t timer;    // Last start (keep-alive) from the host
+    uint16_t last_us;  // Time of the previous sample
+    uint16_t batch_us; // Time of the sample before the report being filled
+    uint8_t seq;       // Incremented on every report, the host sees the lost reports by the gaps
+    uint8_t count;     // Samples in the report being filled
+    uint8_t filling;   // Index of the report being filled
+    uint8_t reports[2][TELEMETRY_REPORT_SIZE];
+};
+
+#define TELEMETRY_INIT {false, false, 0, 0, 0, 0, 0, 0, {{0}}}
+// Called for RAWHID_TELEMETRY from raw_hid_receive(): start (or keep alive) / stop the stream
+void set_telemetry(struct TELEMETRY_STATE *state, bool active);
+// Called after every read_joystick_angles()
+void run_telemetry(struct TELEMETRY_STATE *state, struct JOYSTICK_STATE *js_state);
+// Called from a background task (lib_ion/scheduler.h): sends the queued batch
+void send_telemetry(struct TELEMETRY_STATE *state);
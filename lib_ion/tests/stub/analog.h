@@ -0,0 +1,2 @@
+#pragma once
+// analogReadPin() is declared in quantum.h
@@ -0,0 +1,2 @@
+#pragma once
+#define ATOMIC_BLOCK_FORCEON
@@ -0,0 +1,31 @@
+#pragma once
+// AVR pins and ports for lhp14j/matrix.c: the test reads the ports from its simulated matrix
+#define _BV(bit) (1 << (bit))
+#define PIN_ON_PORT(port, bit) ((port) << 4 | (bit))
+#define PORT_B 1
+#define PORT_C 2
+#define PORT_D 3
+#define PORT_E 4
+#define PORT_F 5
+#define B1 PIN_ON_PORT(PORT_B, 1)
+#define B2 PIN_ON_PORT(PORT_B, 2)
+#define B3 PIN_ON_PORT(PORT_B, 3)
+#define B4 PIN_ON_PORT(PORT_B, 4)
+#define B5 PIN_ON_PORT(PORT_B, 5)
+#define B6 PIN_ON_PORT(PORT_B, 6)
+#define C6 PIN_ON_PORT(PORT_C, 6)
+#define D2 PIN_ON_PORT(PORT_D, 2)
+#define D4 PIN_ON_PORT(PORT_D, 4)
+#define D7 PIN_ON_PORT(PORT_D, 7)
+#define E6 PIN_ON_PORT(PORT_E, 6)
+#define F6 PIN_ON_PORT(PORT_F, 6)
+#define F7 PIN_ON_PORT(PORT_F, 7)
+uint8_t read_port(uint8_t port);
+#define PINB read_port(PORT_B)
+#define PINC read_port(PORT_C)
+#define PIND read_port(PORT_D)
+#define PINF read_port(PORT_F)
+void gpio_set_pin_output(pin_t pin);
+void gpio_write_pin_low(pin_t pin);
+void gpio_set_pin_input_high(pin_t pin);
+bool gpio_read_pin(pin_t pin);
@@ -0,0 +1,14 @@
+#pragma once
+// Host driver of QMK: only the reports that lib_ion/stats.c counts
+typedef struct { uint8_t mods; uint8_t keys[6]; } report_keyboard_t;
+typedef struct { uint8_t mods; uint8_t bits[30]; } report_nkro_t;
+
+typedef struct {
+    uint8_t (*keyboard_leds)(void);
+    void (*send_keyboard)(report_keyboard_t *);
+    void (*send_nkro)(report_nkro_t *);
+    void (*send_mouse)(report_mouse_t *);
+} host_driver_t;
+
+host_driver_t *host_get_driver(void);
+void host_set_driver(host_driver_t *driver);
@@ -0,0 +1,2 @@
+#pragma once
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column);
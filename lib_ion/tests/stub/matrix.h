@@ -0,0 +1,3 @@
+#pragma once
+void matrix_output_select_delay(void);
+void matrix_output_unselect_delay(uint8_t line, bool key_pressed);
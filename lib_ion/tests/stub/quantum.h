@@ -0,0 +1,87 @@
+#pragma once
+// Host stand-in for the QMK headers: only the types, macros and functions that the tested files use.
+// The tests define the functions they call (timer_read() and so on) themselves.
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+
+#define PROGMEM
+#define PSTR(s) s
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_ptr(p) (*(const void *const *)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+// OLED
+#define OLED_DISPLAY_WIDTH 128
+#define OLED_DISPLAY_HEIGHT 32
+void oled_write_raw_byte(const char data, uint16_t index);
+
+// Keycodes and actions
+#define KC_NO 0x0000
+#define MOD_LCTL 0x01
+#define MOD_LSFT 0x02
+#define MOD_LALT 0x04
+#define MOD_LGUI 0x08
+#define MOD_RCTL 0x11
+void register_code16(uint16_t keycode);
+void unregister_code16(uint16_t keycode);
+void tap_code16(uint16_t keycode);
+void register_mods(uint8_t mods);
+void unregister_mods(uint8_t mods);
+
+// Timer
+#define TIMER_DIFF_16(a, b) ((uint16_t)((a) - (b)))
+uint16_t timer_read(void);
+uint16_t timer_elapsed(uint16_t last);
+
+// Matrix of the LHP14j
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 9
+typedef uint16_t matrix_row_t;
+
+// Joystick (the board config.h of lhp14lite_d for the stick)
+#ifndef JOYSTICK_AXIS_RESOLUTION
+#define JOYSTICK_AXIS_RESOLUTION 8
+#endif
+#define JOYSTICK_MAX_VALUE ((1L << (JOYSTICK_AXIS_RESOLUTION - 1)) - 1)
+typedef uint8_t pin_t;
+#define JS_PIN_X 5
+#define JS_PIN_Y 4
+#define JS_X_LOW 784
+#define JS_X_MID 444
+#define JS_X_HIGH 172
+#define JS_Y_LOW 244
+#define JS_Y_MID 532
+#define JS_Y_HIGH 822
+typedef struct { int16_t axes[6]; uint8_t buttons[4]; int8_t hat; bool dirty; } joystick_t;
+extern joystick_t joystick_state;
+int16_t analogReadPin(pin_t pin);
+void joystick_set_axis(uint8_t axis, int16_t value);
+void joystick_flush(void);
+void register_joystick_button(uint8_t button);
+void unregister_joystick_button(uint8_t button);
+#define JOYSTICK_HAT_CENTER -1
+void joystick_set_hat(int8_t hat);
+#define QK_JOYSTICK_BUTTON_0 0x7400
+#define QK_JOYSTICK_BUTTON_MAX 0x741F
+typedef struct { int8_t x, y, v, h; uint8_t buttons; } report_mouse_t;
+report_mouse_t pointing_device_get_report(void);
+void pointing_device_set_report(report_mouse_t report);
+void pointing_device_send(void);
+
+// Key records (lib_ion/stats.c logs them, lib_ion/gamepad.c reads pressed)
+typedef struct { uint8_t col; uint8_t row; } keypos_t;
+#define TICK_EVENT 0
+#define KEY_EVENT 1
+typedef struct { bool pressed; uint16_t time; keypos_t key; uint8_t type; } keyevent_t;
+typedef struct keyrecord_t { keyevent_t event; } keyrecord_t;
+#define IS_KEYEVENT(event) ((event).type == KEY_EVENT)
+
+// EEPROM block of the keymap (EECONFIG_USER_DATA_SIZE)
+bool eeconfig_is_user_datablock_valid(void);
+void eeconfig_read_user_datablock(void *data, uint8_t offset, uint8_t size);
+void eeconfig_update_user_datablock(const void *data, uint8_t offset, uint8_t size);
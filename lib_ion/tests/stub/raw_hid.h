@@ -0,0 +1,2 @@
+#pragma once
+void raw_hid_send(uint8_t *data, uint8_t length);
@@ -0,0 +1,3 @@
+#pragma once
+uint32_t timer_read32(void);
+uint32_t timer_elapsed32(uint32_t last);
@@ -0,0 +1,2 @@
+#pragma once
+void wait_us(uint16_t us);
@@ -0,0 +1,51 @@
+// lib_ion/tools/bitmap.py で変換したロゴを render_bitmap_P() で展開し、元の PBM の画素と比べる
+#include "quantum.h"
+#include "lib_ion/bitmap.h"
+
+// BITMAP_HEADER: bitmap.py の出力 (lhp_logo_bitmap), BITMAP_PBM: 元の画像 (P1)
+#include BITMAP_HEADER
+
+static uint8_t buffer[OLED_DISPLAY_WIDTH * OLED_DISPLAY_HEIGHT / 8];
+
+void oled_write_raw_byte(const char data, uint16_t index) {
+    if (index < sizeof(buffer)) buffer[index] = data;
+}
+
+static int read_pixel(FILE *file) {
+    int c;
+    while ((c = fgetc(file)) == ' ' || c == '\n' || c == '\r');
+    return c - '0';
+}
+
+int main(void) {
+    // P1 の PBM: 1行目が "P1"、'#' の行はコメント、次の行が幅と高さ
+    FILE *file = fopen(BITMAP_PBM, "r");
+    char line[256];
+    int width = 0, height = 0;
+    if (file == NULL || fgets(line, sizeof(line), file) == NULL || strncmp(line, "P1", 2) != 0) return 1;
+    while (fgets(line, sizeof(line), file) != NULL && line[0] == '#');
+    if (sscanf(line, "%d %d", &width, &height) != 2) return 1;
+    if (width != LHP_LOGO_BITMAP_WIDTH || (height + 7) / 8 != LHP_LOGO_BITMAP_PAGES) return 1;
+    // 周りに書き込んでいないことも確かめるため、右下に寄せて描く
+    const uint8_t x = OLED_DISPLAY_WIDTH - LHP_LOGO_BITMAP_WIDTH, page = OLED_DISPLAY_HEIGHT / 8 - LHP_LOGO_BITMAP_PAGES;
+    memset(buffer, 0xAA, sizeof(buffer));
+    render_bitmap_P(lhp_logo_bitmap, x, page, LHP_LOGO_BITMAP_WIDTH, LHP_LOGO_BITMAP_PAGES);
+    long failures = 0;
+    for (int y = 0; y < height; y++) {
+        for (int col = 0; col < width; col++) {
+            int pixel = read_pixel(file);
+            int index = (page + y / 8) * OLED_DISPLAY_WIDTH + x + col;
+            if (((buffer[index] >> (y % 8)) & 1) != pixel) failures++;
+        }
+    }
+    fclose(file);
+    // 描いた範囲の外はそのまま
+    for (int index = 0; index < (int)sizeof(buffer); index++) {
+        int col = index % OLED_DISPLAY_WIDTH - x, p = index / OLED_DISPLAY_WIDTH - page;
+        bool inside = col >= 0 && col < width && p >= 0 && p < LHP_LOGO_BITMAP_PAGES;
+        if (!inside && buffer[index] != 0xAA) failures++;
+    }
+    printf("bitmap %s (%s, %u bytes): %ld failures\n", BITMAP_PBM, lhp_logo_bitmap[0] == BITMAP_RLE ? "RLE" : "raw",
+           (unsigned)sizeof(lhp_logo_bitmap), failures);
+    return failures != 0;
+}
@@ -0,0 +1,151 @@
+// lib_ion/eager_debounce.c: 押したときはすぐ送り、離したときは離れたままの時間を待ってから送る
+// DEBOUNCE_RELEASE だけ、DEBOUNCE_RELEASE_ROWS、DEBOUNCE_RELEASE_KEYS でビルドする
+#include "quantum.h"
+#include "debounce.h"
+#include "lib_ion/eager_debounce.h"
+
+#if defined(DEBOUNCE_RELEASE_KEYS)
+static const uint8_t release_times[MATRIX_ROWS][MATRIX_COLS] = DEBOUNCE_RELEASE_KEYS;
+#    define RELEASE_TIME(row, col) release_times[row][col]
+#    define VARIANT "keys"
+#elif defined(DEBOUNCE_RELEASE_ROWS)
+static const uint8_t release_times[MATRIX_ROWS] = DEBOUNCE_RELEASE_ROWS;
+#    define RELEASE_TIME(row, col) release_times[row]
+#    define VARIANT "rows"
+#else
+#    define RELEASE_TIME(row, col) DEBOUNCE_RELEASE
+#    define VARIANT "default"
+#endif
+// eager_debounce.c の時間の最大値 (DEBOUNCE_TIME_MASK)
+#define DEBOUNCE_TIME_MAX 127
+
+// 1ms に何回スキャンするか (1: 毎回 elapsed = 1, 4: ほとんどのスキャンで elapsed = 0)
+static uint8_t scans_per_ms;
+static uint16_t now;
+static uint8_t scan_in_ms;
+static matrix_row_t raw[MATRIX_ROWS], cooked[MATRIX_ROWS];
+static long failures = 0;
+
+uint16_t timer_read(void) { return now; }
+
+static void reset(void) {
+    // タイマーが 65535 から 0 に戻るところを通る
+    now = 65500;
+    scan_in_ms = 0;
+    memset(raw, 0, sizeof(raw));
+    memset(cooked, 0, sizeof(cooked));
+    debounce_init(MATRIX_ROWS);
+    // 前のトレースで数えていた時間を終わらせる
+    for (uint8_t i = 0; i < 2 * DEBOUNCE_TIME_MAX; i++) debounce(raw, cooked, MATRIX_ROWS, false);
+}
+
+static void scan(bool changed) {
+    if (++scan_in_ms == scans_per_ms) {
+        scan_in_ms = 0;
+        now++;
+    }
+    debounce(raw, cooked, MATRIX_ROWS, changed);
+}
+
+static void set_key(uint8_t row, uint8_t col, bool pressed) {
+    if (pressed) raw[row] |= (matrix_row_t)1 << col;
+    else raw[row] &= ~((matrix_row_t)1 << col);
+}
+
+static bool is_cooked(uint8_t row, uint8_t col) {
+    return cooked[row] & ((matrix_row_t)1 << col);
+}
+
+// ms ミリ秒のスキャン。キーの送った状態が変わった回数を返す
+static uint16_t run(uint16_t ms, uint8_t row, uint8_t col, bool changed) {
+    uint16_t edges = 0;
+    bool last = is_cooked(row, col);
+    for (uint16_t i = 0; i < ms * scans_per_ms; i++) {
+        scan(changed && i == 0);
+        if (is_cooked(row, col) != last) edges++;
+        last = is_cooked(row, col);
+    }
+    return edges;
+}
+
+static void expect(bool ok, uint8_t row, uint8_t col, const char *what) {
+    if (ok) return;
+    failures++;
+    printf("%u scans/ms, key %u,%u: %s\n", scans_per_ms, row, col, what);
+}
+
+// 離してから送るまでの時間 (タイマーの ms)
+static uint16_t release_latency(uint8_t row, uint8_t col) {
+    set_key(row, col, false);
+    scan(true);
+    uint16_t start = now;
+    while (is_cooked(row, col) && (uint16_t)(now - start) <= DEBOUNCE_TIME_MAX) scan(false);
+    return now - start;
+}
+
+static void test_key(uint8_t row, uint8_t col) {
+    uint8_t release = RELEASE_TIME(row, col);
+
+    // 押したスキャンですぐ送る
+    reset();
+    set_key(row, col, true);
+    scan(true);
+    expect(is_cooked(row, col), row, col, "the press is sent in the same scan");
+    // 押した直後のチャタリングは DEBOUNCE_PRESS_LOCK の間無視する
+    for (uint8_t ms = 0; ms + 1 < DEBOUNCE_PRESS_LOCK; ms++) {
+        set_key(row, col, ms & 1);
+        expect(run(1, row, col, true) == 0 && is_cooked(row, col), row, col, "a bounce of the press is ignored");
+    }
+    set_key(row, col, true);
+    run(DEBOUNCE_PRESS_LOCK, row, col, true);
+    expect(is_cooked(row, col), row, col, "the key is still pressed after the lock");
+
+    // 離したときは RELEASE_TIME だけ待って送る
+    uint16_t latency = release_latency(row, col);
+    if (latency != release) {
+        failures++;
+        printf("%u scans/ms, key %u,%u: the release is sent after %u ms, expected %u\n", scans_per_ms, row, col, latency, release);
+    }
+
+    // 待っている間にまた押されたら、離したのはチャタリングとして取り消す
+    if (release >= 2) {
+        reset();
+        set_key(row, col, true);
+        run(DEBOUNCE_PRESS_LOCK + 1, row, col, true);
+        set_key(row, col, false);
+        uint16_t edges = run(release - 1, row, col, true);
+        set_key(row, col, true);
+        edges += run(1, row, col, true);
+        expect(edges == 0 && is_cooked(row, col), row, col, "a bounce of the release is ignored");
+        latency = release_latency(row, col);
+        expect(latency == release, row, col, "the release after the bounce waits again");
+    }
+}
+
+int main(void) {
+    static const uint8_t rates[] = {1, 4};
+    for (uint8_t i = 0; i < ARRAY_SIZE(rates); i++) {
+        scans_per_ms = rates[i];
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) test_key(row, col);
+        }
+
+        // 全てのキーを同時に離しても、キーごとの時間で送る
+        reset();
+        memset(raw, 0xFF, sizeof(raw));
+        run(DEBOUNCE_PRESS_LOCK + 1, 0, 0, true);
+        memset(raw, 0, sizeof(raw));
+        scan(true);
+        for (uint16_t start = now; (uint16_t)(now - start) <= DEBOUNCE_TIME_MAX; scan(false)) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    bool is_pending = (uint16_t)(now - start) < RELEASE_TIME(row, col);
+                    expect(is_cooked(row, col) == is_pending, row, col, "all keys released together");
+                }
+            }
+        }
+    }
+
+    printf("debounce (%s): %ld failures\n", VARIANT, failures);
+    return failures != 0;
+}
@@ -0,0 +1,35 @@
+// lib_ion/format.c を全ての 16 ビットの値・幅で printf と比べる
+#include "quantum.h"
+#include "lib_ion/format.h"
+
+static long failures = 0;
+
+static void check(const char *kind, uint8_t width, long val, const char *got, const char *fmt) {
+    char expected[16];
+    snprintf(expected, sizeof(expected), fmt, width, val);
+    // 幅に収まらない値は '#' で埋める
+    if (strlen(expected) > width) {
+        memset(expected, '#', width);
+        expected[width] = '\0';
+    }
+    if (strcmp(got, expected) == 0) return;
+    if (failures++ < 10) printf("%s width %u, %ld: \"%s\", expected \"%s\"\n", kind, width, val, got, expected);
+}
+
+int main(void) {
+    char buf[FORMAT_BUFFER_SIZE(FORMAT_WIDTH_MAX)];
+    for (uint8_t width = FORMAT_WIDTH_MIN; width <= FORMAT_WIDTH_MAX; width++) {
+        for (long val = 0; val <= UINT16_MAX; val++) {
+            format_uint(buf, val, width);
+            check("uint", width, val, buf, "%*lu");
+            format_hex(buf, val, width);
+            check("hex", width, val, buf, "%0*lX");
+        }
+        for (long val = INT16_MIN; val <= INT16_MAX; val++) {
+            format_int(buf, val, width);
+            check("int", width, val, buf, "%*ld");
+        }
+    }
+    printf("format: %ld failures\n", failures);
+    return failures != 0;
+}
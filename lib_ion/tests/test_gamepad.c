@@ -0,0 +1,152 @@
+// lib_ion/gamepad.c: ハットスイッチのキーとボタンはスティックの使い方によらず送り、スティックの分は使わないときに中央に戻す
+// 連打 (lib_ion/joystick.c) も GAMEPAD_REPORT ではその場で送らず、report_gamepad() でまとめて送る
+#include "quantum.h"
+#include "lib_ion/gamepad.h"
+#include "lib_ion/gesture.h"
+
+// keymap の HAT_UP から4つ
+#define HAT_KEYCODE 0x7E00
+// 倒し切ったところ
+#define STICK_MAX JOYSTICK_MAX_VALUE
+
+joystick_t joystick_state;
+static joystick_t sent_report;
+static uint16_t sent;
+static long failures = 0;
+static uint16_t now;
+
+uint16_t timer_read(void) { return now; }
+uint16_t timer_elapsed(uint16_t last) { return now - last; }
+int16_t analogReadPin(pin_t pin) { return 0; }
+report_mouse_t pointing_device_get_report(void) { report_mouse_t report = {0}; return report; }
+void pointing_device_set_report(report_mouse_t report) {}
+void pointing_device_send(void) {}
+// その場で送る QMK の関数は使わない
+void register_joystick_button(uint8_t button) {
+    failures++;
+    printf("button %u is sent at once\n", button);
+}
+void unregister_joystick_button(uint8_t button) { register_joystick_button(button); }
+
+// QMK と同じく、値が変わったときだけ dirty にする
+void joystick_set_hat(int8_t hat) {
+    if (joystick_state.hat == hat) return;
+    joystick_state.hat = hat;
+    joystick_state.dirty = true;
+}
+void joystick_set_axis(uint8_t axis, int16_t value) {
+    if (joystick_state.axes[axis] == value) return;
+    joystick_state.axes[axis] = value;
+    joystick_state.dirty = true;
+}
+void joystick_flush(void) {
+    if (!joystick_state.dirty) return;
+    joystick_state.dirty = false;
+    sent_report = joystick_state;
+    sent++;
+}
+
+static struct GAMEPAD_STATE gamepad = GAMEPAD_INIT(HAT_KEYCODE);
+
+static void key(uint16_t keycode, bool pressed) {
+    keyrecord_t record = {.event = {.pressed = pressed, .type = KEY_EVENT}};
+    if (process_gamepad(&gamepad, keycode, &record)) {
+        failures++;
+        printf("keycode 0x%04X is not processed\n", keycode);
+    }
+}
+
+// 1スキャン分送って、送ったレポートを確かめる
+static void expect_scan(struct JOYSTICK_STATE *stick, uint16_t reports, int8_t hat, int16_t x, int16_t y, const char *what) {
+    sent = 0;
+    report_gamepad(&gamepad, stick);
+    if (sent == reports && sent_report.hat == hat && sent_report.axes[0] == x && sent_report.axes[1] == y) return;
+    failures++;
+    printf("%s: %u reports, hat %d, axes %d, %d\n", what, sent, sent_report.hat, sent_report.axes[0], sent_report.axes[1]);
+}
+
+int main(void) {
+    struct JOYSTICK_STATE js_state = JS_INIT;
+    joystick_state.hat = JOYSTICK_HAT_CENTER;
+    sent_report.hat = JOYSTICK_HAT_CENTER;
+
+    // ゲームパッドのモードでスティックを倒してから、マウスやジェスチャーのモード (NULL) に変えると中央に戻る
+    js_state.x = STICK_MAX;
+    js_state.y = -STICK_MAX;
+    expect_scan(&js_state, 1, JOYSTICK_HAT_CENTER, STICK_MAX, -STICK_MAX, "the stick as the gamepad");
+    expect_scan(NULL, 1, JOYSTICK_HAT_CENTER, 0, 0, "the axes are centered when the mode changes");
+    expect_scan(NULL, 0, JOYSTICK_HAT_CENTER, 0, 0, "no report while nothing changes");
+
+    // ハットスイッチのキーとボタンはどのモードでも送る。同じスキャンの変化は1回にまとめる
+    struct JOYSTICK_STATE *const sticks[] = {&js_state, NULL};
+    for (uint8_t i = 0; i < ARRAY_SIZE(sticks); i++) {
+        int16_t x = sticks[i] != NULL ? js_state.x : 0;
+        int16_t y = sticks[i] != NULL ? js_state.y : 0;
+        expect_scan(sticks[i], 1, JOYSTICK_HAT_CENTER, x, y, "the mode is set");
+        key(HAT_KEYCODE + GAMEPAD_HAT_RIGHT, true);
+        expect_scan(sticks[i], 1, GESTURE_RIGHT, x, y, "a hat key");
+        key(HAT_KEYCODE + GAMEPAD_HAT_UP, true);
+        expect_scan(sticks[i], 1, GESTURE_UP_RIGHT, x, y, "two hat keys are diagonal");
+        key(HAT_KEYCODE + GAMEPAD_HAT_DOWN, true);
+        expect_scan(sticks[i], 1, GESTURE_RIGHT, x, y, "opposite hat keys cancel");
+        key(HAT_KEYCODE + GAMEPAD_HAT_RIGHT, false);
+        key(HAT_KEYCODE + GAMEPAD_HAT_UP, false);
+        key(HAT_KEYCODE + GAMEPAD_HAT_DOWN, false);
+        key(QK_JOYSTICK_BUTTON_0 + 3, true);
+        key(QK_JOYSTICK_BUTTON_0 + 12, true);
+        expect_scan(sticks[i], 1, JOYSTICK_HAT_CENTER, x, y, "the hat keys are released with two buttons pressed");
+        if (sent_report.buttons[0] != 0x08 || sent_report.buttons[1] != 0x10) {
+            failures++;
+            printf("buttons 0x%02X 0x%02X\n", sent_report.buttons[0], sent_report.buttons[1]);
+        }
+        key(QK_JOYSTICK_BUTTON_0 + 3, false);
+        key(QK_JOYSTICK_BUTTON_0 + 12, false);
+        expect_scan(sticks[i], 1, JOYSTICK_HAT_CENTER, x, y, "the buttons are released");
+    }
+
+    // 十字キーのモード: スティックはハットスイッチになり、ハットスイッチのキーが優先。モードを変えると中央に戻る
+    gamepad.stick_hat = true;
+    js_state.x = STICK_MAX;
+    js_state.y = 0;
+    expect_scan(&js_state, 1, GESTURE_RIGHT, 0, 0, "the stick presses the hat");
+    key(HAT_KEYCODE + GAMEPAD_HAT_LEFT, true);
+    expect_scan(&js_state, 1, GESTURE_LEFT, 0, 0, "the hat keys win over the stick");
+    key(HAT_KEYCODE + GAMEPAD_HAT_LEFT, false);
+    js_state.x = GAMEPAD_HAT_THRESHOLD - 1;
+    expect_scan(&js_state, 1, JOYSTICK_HAT_CENTER, 0, 0, "the stick below the threshold");
+    js_state.x = STICK_MAX;
+    expect_scan(&js_state, 1, GESTURE_RIGHT, 0, 0, "the stick presses the hat again");
+    expect_scan(NULL, 1, JOYSTICK_HAT_CENTER, 0, 0, "the stick hat is centered when the mode changes");
+
+    // 連打は間隔ごとにボタンを変えるだけで、スキャンの最後に1回だけ送る。止めると離す
+    struct JOYSTICK_RAPID_STATE rapid = JS_RAPID_INIT(1);
+    gamepad.stick_hat = false;
+    js_state.x = js_state.y = 0;
+    expect_scan(&js_state, 0, JOYSTICK_HAT_CENTER, 0, 0, "the stick is centered");
+    start_joystick_rapid(&rapid);
+    for (uint8_t i = 0; i < 4; i++) {
+        now += rapid.interval;
+        if (!run_joystick_rapid(&rapid)) failures++;
+        bool pressed = i % 2 == 0;
+        expect_scan(&js_state, 1, JOYSTICK_HAT_CENTER, 0, 0, "a rapid fire step");
+        if ((sent_report.buttons[0] == 0x02) != pressed) {
+            failures++;
+            printf("rapid fire step %u: buttons 0x%02X\n", i, sent_report.buttons[0]);
+        }
+    }
+    now += rapid.interval;
+    run_joystick_rapid(&rapid);
+    stop_joystick_rapid(&rapid);
+    expect_scan(&js_state, 1, JOYSTICK_HAT_CENTER, 0, 0, "the rapid fire is stopped");
+    if (sent_report.buttons[0] != 0) failures++;
+
+    // ハットスイッチのキーの前後のキーは処理しない
+    keyrecord_t record = {.event = {.pressed = true, .type = KEY_EVENT}};
+    if (!process_gamepad(&gamepad, HAT_KEYCODE + 4, &record) || !process_gamepad(&gamepad, HAT_KEYCODE - 1, &record)) {
+        failures++;
+        printf("other keycodes are processed\n");
+    }
+
+    printf("gamepad: %ld failures\n", failures);
+    return failures != 0;
+}
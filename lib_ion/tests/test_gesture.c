@@ -0,0 +1,81 @@
+// lib_ion/gesture.c: 1ms ごとのスティックの軌跡から、はじき・長押し・1/4回転・半回転を判定する
+// JOYSTICK_AXIS_RESOLUTION 8 と 16 でビルドする (軌跡は最大値に合わせて拡大する)
+#include <math.h>
+#include "quantum.h"
+#include "lib_ion/gesture.h"
+
+// 8ビットで 120 / 127 の距離 (閾値と最大値の間)
+#define TRACE_LENGTH (120.0 * JOYSTICK_MAX_VALUE / 127)
+// 開始から10ms は中央
+#define TRACE_START 10
+
+static long failures = 0;
+
+// 倒す方向ごとの x と y (上が負)
+static const int8_t direction_x[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+static const int8_t direction_y[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+struct TRACE {
+    const char *name;
+    double from, to;  // 角度 (上が0、時計回り)。同じなら倒すだけ
+    uint16_t length;  // 中央から出ている時間 (ms)
+};
+
+// 軌跡を再生して、見つかったジェスチャーの数を返す (最初のものを *gesture に)
+// タイマーは途中で 65535 から 0 に戻る
+static uint8_t play(const struct TRACE *trace, uint8_t *gesture) {
+    struct GESTURE_STATE state = GESTURE_INIT;
+    uint8_t found = 0;
+    *gesture = GESTURE_NONE;
+    for (uint16_t t = 0; t < TRACE_START + trace->length + 100; t++) {
+        int16_t x = 0, y = 0;
+        if (t >= TRACE_START && t < TRACE_START + trace->length) {
+            double a = trace->from;
+            if (trace->length > 1) a += (trace->to - trace->from) * (t - TRACE_START) / (trace->length - 1);
+            x = lround(TRACE_LENGTH * sin(a));
+            y = lround(-TRACE_LENGTH * cos(a));
+        }
+        uint8_t g = run_gesture(&state, x, y, (uint16_t)(65000 + t));
+        if (g == GESTURE_NONE) continue;
+        if (found++ == 0) *gesture = g;
+    }
+    return found;
+}
+
+static void expect(const struct TRACE *trace, uint8_t expected) {
+    uint8_t gesture;
+    uint8_t found = play(trace, &gesture);
+    if (found == (expected != GESTURE_NONE) && gesture == expected) return;
+    failures++;
+    printf("%s (%.2f -> %.2f, %u ms): %u gestures, first %u, expected %u\n",
+           trace->name, trace->from, trace->to, trace->length, found, gesture, expected);
+}
+
+int main(void) {
+    for (uint8_t d = 0; d < 8; d++) {
+        double a = atan2(direction_x[d], -direction_y[d]);
+        // 45度の真ん中で方向が決まる
+        uint8_t direction = stick_direction(lround(TRACE_LENGTH * sin(a)), lround(-TRACE_LENGTH * cos(a)));
+        if (direction != d) {
+            failures++;
+            printf("direction %u: %u\n", d, direction);
+        }
+        // GESTURE_FLICK_TIME より短ければはじき、GESTURE_HOLD_TIME 倒したままなら長押し、その間は何もしない
+        expect(&(struct TRACE){"flick", a, a, 80}, GESTURE_FLICK + d);
+        expect(&(struct TRACE){"slow", a, a, 300}, GESTURE_NONE);
+        expect(&(struct TRACE){"hold", a, a, 700}, GESTURE_HOLD + d);
+    }
+    // 下から右・左へ1/4回転
+    expect(&(struct TRACE){"quarter", M_PI, M_PI / 2, 150}, GESTURE_QUARTER_CCW);
+    expect(&(struct TRACE){"quarter", M_PI, 3 * M_PI / 2, 150}, GESTURE_QUARTER_CW);
+    // 右から下を通って左へ半回転、その逆
+    expect(&(struct TRACE){"half", M_PI / 2, 3 * M_PI / 2, 250}, GESTURE_HALF_CW);
+    expect(&(struct TRACE){"half", 3 * M_PI / 2, M_PI / 2, 250}, GESTURE_HALF_CCW);
+    // 20ms で半回転すると1スキャンで方向を飛ばす
+    expect(&(struct TRACE){"fast half", 3 * M_PI / 2, M_PI / 2, 20}, GESTURE_HALF_CCW);
+    // 20周回してもあふれない
+    expect(&(struct TRACE){"spin", 0, 40 * M_PI, 2000}, GESTURE_HALF_CW);
+
+    printf("gesture (%d bits): %ld failures\n", JOYSTICK_AXIS_RESOLUTION, failures);
+    return failures != 0;
+}
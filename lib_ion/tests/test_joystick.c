@@ -0,0 +1,65 @@
+// lib_ion/joystick.c: 除算を使わない角度・2乗のカーブ・マウスの速さを、全ての ADC の値で除算と比べる
+// JOYSTICK_AXIS_RESOLUTION 8 と 16 でビルドする
+#include <stdlib.h>
+#include "quantum.h"
+#include "lib_ion/joystick.h"
+
+joystick_t joystick_state;
+static int16_t adc_x, adc_y;
+static long failures = 0;
+
+int16_t analogReadPin(pin_t pin) { return pin == JS_PIN_X ? adc_x : adc_y; }
+void joystick_set_axis(uint8_t axis, int16_t value) {}
+void joystick_flush(void) {}
+void register_joystick_button(uint8_t button) {}
+void unregister_joystick_button(uint8_t button) {}
+report_mouse_t pointing_device_get_report(void) { report_mouse_t report = {0}; return report; }
+void pointing_device_set_report(report_mouse_t report) {}
+void pointing_device_send(void) {}
+uint16_t timer_read(void) { return 0; }
+uint16_t timer_elapsed(uint16_t last) { return 0; }
+
+static void expect(bool ok, const char *what, long val, long got, long ref) {
+    if (ok) return;
+    if (failures++ < 10) printf("%s %ld: %ld, expected %ld\n", what, val, got, ref);
+}
+
+int main(void) {
+    // 角度: 8ビットは除算と同じ、16ビットは係数を切り上げるので除算より最大1大きい (JS_ANGLE_SHIFT)。最大値は超えない
+    const long tolerance = JOYSTICK_AXIS_RESOLUTION > 8;
+    static const int16_t calibrations[][3] = {{JS_X_LOW, JS_X_MID, JS_X_HIGH}, {JS_Y_LOW, JS_Y_MID, JS_Y_HIGH}, {0, 1, JS_ADC_MAX}, {JS_ADC_MAX, 100, 99}};
+    for (uint8_t i = 0; i < ARRAY_SIZE(calibrations); i++) {
+        struct JOYSTICK_AXIS_CALIBRATION c;
+        set_joystick_calibration(&c, calibrations[i][0], calibrations[i][1], calibrations[i][2]);
+        for (long raw = 0; raw <= JS_ADC_MAX; raw++) {
+            long distance = raw - c.mid;
+            bool is_high = (distance > 0) == (c.high > c.mid);
+            long range = is_high ? c.high_range : c.low_range;
+            long length = labs(distance) < range ? labs(distance) : range;
+            long ref = length * JOYSTICK_MAX_VALUE / range * (is_high ? 1 : -1);
+            long got = joystick_angle(raw, &c);
+            expect(labs(got - ref) <= tolerance && labs(got) <= JOYSTICK_MAX_VALUE, "angle", raw, got, ref);
+        }
+    }
+
+    // 2乗のカーブ: 直線の出力を x * |x| / JOYSTICK_MAX_VALUE にしたものと同じ
+    struct JOYSTICK_STATE linear = JS_INIT, quadratic = JS_INIT;
+    linear.profile = (struct JOYSTICK_PROFILE)JS_PROFILE(false, JS_CURVE_LINEAR, 0, 60, 20);
+    quadratic.profile = (struct JOYSTICK_PROFILE)JS_PROFILE(false, JS_CURVE_QUADRATIC, 0, 60, 20);
+    for (adc_x = 0; adc_x <= JS_ADC_MAX; adc_x++) {
+        adc_y = JS_ADC_MAX - adc_x;
+        read_joystick_angles(&linear);
+        read_joystick_angles(&quadratic);
+        long x = linear.x, y = linear.y;
+        expect(quadratic.x == x * labs(x) / JOYSTICK_MAX_VALUE, "curve x", x, quadratic.x, x * labs(x) / JOYSTICK_MAX_VALUE);
+        expect(quadratic.y == y * labs(y) / JOYSTICK_MAX_VALUE, "curve y", y, quadratic.y, y * labs(y) / JOYSTICK_MAX_VALUE);
+    }
+    // 端まで倒したときは最大値になる
+    struct JOYSTICK_AXIS_CALIBRATION c = quadratic.calibration[0];
+    adc_x = c.high;
+    read_joystick_angles(&quadratic);
+    expect(quadratic.x == JOYSTICK_MAX_VALUE, "curve at the end", adc_x, quadratic.x, JOYSTICK_MAX_VALUE);
+
+    printf("joystick (%d bits): %ld failures\n", JOYSTICK_AXIS_RESOLUTION, failures);
+    return failures != 0;
+}
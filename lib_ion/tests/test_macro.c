@@ -0,0 +1,79 @@
+// lib_ion/macro.c: 押したキーが全て離されること (押したままにできる数を超えたときも)、待ち時間と順番
+#include "quantum.h"
+#include "lib_ion/macro.h"
+
+static uint16_t now;
+static int pressed_count, press_events, taps;
+static uint8_t mods;
+static long failures = 0;
+
+uint16_t timer_read(void) { return now; }
+uint16_t read_timer_us(void) { return now * 1000U; }
+uint16_t timer_elapsed(uint16_t last) { return now - last; }
+void register_code16(uint16_t keycode) { pressed_count++; press_events++; }
+void unregister_code16(uint16_t keycode) { pressed_count--; }
+void tap_code16(uint16_t keycode) { taps++; }
+void register_mods(uint8_t m) { mods |= m; }
+void unregister_mods(uint8_t m) { mods &= ~m; }
+
+static struct MACRO_STATE state = MACRO_INIT;
+
+static void expect(bool ok, const char *what) {
+    if (ok) return;
+    failures++;
+    printf("%u ms: %s\n", now, what);
+}
+
+static void run(uint16_t ms) {
+    for (uint16_t end = now + ms; now != end; now++) run_macros(&state);
+}
+
+// MACRO_MAX_HELD (4) より1つ多く押す
+static const uint8_t too_many[] = {
+    MC_PRESS(0x04), MC_PRESS(0x05), MC_PRESS(0x06), MC_PRESS(0x07), MC_PRESS(0x08), MC_DELAY(10), MC_END,
+};
+static const uint8_t wrapped[] = { MC_WRAP(MOD_LALT), MC_TAP(0x1F), MC_DELAY(20), MC_TAP(0x20), MC_END };
+static const uint8_t short_tap[] = { MC_TAP(0x21), MC_END };
+
+int main(void) {
+    _Static_assert(MACRO_MAX_HELD == 4, "too_many presses MACRO_MAX_HELD + 1 keys");
+    now = 1000;
+
+    // 覚えておけない5つ目のキーは押さず、終わりに全て離す
+    start_macro(&state, too_many);
+    expect(pressed_count == MACRO_MAX_HELD && press_events == MACRO_MAX_HELD, "only MACRO_MAX_HELD keys are held");
+    run(20);
+    expect(state.step == NULL, "too_many has ended");
+    expect(pressed_count == 0, "the held keys are released at the end");
+
+    // 中断しても押したままのキーと修飾キーは残らない
+    start_macro(&state, too_many);
+    stop_macros(&state);
+    expect(pressed_count == 0, "the held keys are released by stop_macros");
+    start_macro(&state, wrapped);
+    expect(mods == MOD_LALT && taps == 1, "the first steps run at once");
+    stop_macros(&state);
+    expect(mods == 0, "the wrapped modifiers are released by stop_macros");
+
+    // MACRO_POLICY_QUEUE: 待ち時間の後に、キューのマクロを順に実行する
+    taps = 0;
+    start_macro(&state, wrapped);
+    expect(start_macro(&state, short_tap), "a second macro is queued");
+    run(19);
+    expect(taps == 1, "the delay is waited");
+    run(2);
+    expect(taps == 3 && mods == 0 && state.step == NULL, "the queued macro runs after the first one");
+    for (uint8_t i = 0; i <= MACRO_QUEUE_SIZE; i++) start_macro(&state, wrapped);
+    expect(!start_macro(&state, short_tap), "a full queue drops the macro");
+    stop_macros(&state);
+
+    // 計測ではマクロを開始せず、キーも押さない
+    static const uint8_t *const table[] = {wrapped, short_tap};
+    struct MACRO_DISPATCH_BENCHMARK benchmark;
+    press_events = taps = 0;
+    run_macro_benchmark(&benchmark, &state, 0x7E00, table, ARRAY_SIZE(table));
+    expect(state.step == NULL && state.queue_count == 0 && press_events == 0 && taps == 0, "the benchmark starts no macro");
+
+    printf("macro: %ld failures\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,122 @@
+// lhp14j/matrix.c: ポートごとに読むスキャンを、1本ずつ読んで毎回待つスキャン (QMK の標準と同じ) とビットごとに比べる
+// 行を選ぶと押されたキーの列が Low になり、行を戻した後も列は数 us かけて High に戻る。
+// チャタリングで、読んだときは開いていたキーが行を戻す前に閉じることもある (その行は 0 と読める)
+#include <stdlib.h>
+#define MATRIX_SCAN_BENCHMARK 1000
+#define MATRIX_ROW_PINS {D7, E6, B4, B5}
+#define MATRIX_COL_PINS {D4, F6, F7, B1, B3, B2, B6, C6, D2}
+#include "lhp14j/matrix.c"
+
+#define TRACE_SCANS 200000
+// 列が High に戻るまでの最大の時間 (us)。MATRIX_IO_DELAY より短い
+#define SETTLE_MAX_US 20
+
+static int8_t selected = -1;              // Low にしている行
+static matrix_row_t keys[MATRIX_ROWS];    // 押されているキー
+static matrix_row_t bounces[MATRIX_ROWS]; // 読んだ後、行を戻す前に閉じるキー
+static uint8_t settling[MATRIX_COLS];     // 列が High に戻るまでの時間 (us)
+static uint32_t waited_us;
+static long failures = 0;
+
+static bool is_col_low(uint8_t col) {
+    return settling[col] > 0 || (selected >= 0 && (keys[selected] >> col & 1));
+}
+
+uint8_t read_port(uint8_t port) {
+    // 列でないビット (行のピンなど) はでたらめな値
+    uint8_t value = rand();
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (col_pins[col] >> 4 != port) continue;
+        uint8_t bit = _BV(col_pins[col] & 0x0F);
+        value = is_col_low(col) ? value & ~bit : value | bit;
+    }
+    return value;
+}
+
+bool gpio_read_pin(pin_t pin) {
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (col_pins[col] == pin) return !is_col_low(col);
+    }
+    return true;
+}
+
+void gpio_set_pin_output(pin_t pin) {}
+
+void gpio_write_pin_low(pin_t pin) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (row_pins[row] == pin) selected = row;
+    }
+}
+
+void gpio_set_pin_input_high(pin_t pin) {
+    if (selected < 0 || row_pins[selected] != pin) return;
+    // 行を戻すと、Low にしていた列が少しずつ High に戻る
+    matrix_row_t low = keys[selected] | bounces[selected];
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (low >> col & 1) settling[col] = 1 + rand() % SETTLE_MAX_US;
+    }
+    selected = -1;
+}
+
+void wait_us(uint16_t us) {
+    waited_us += us;
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        settling[col] = settling[col] > us ? settling[col] - us : 0;
+    }
+}
+
+void matrix_output_select_delay(void) {}
+void matrix_output_unselect_delay(uint8_t line, bool key_pressed) { wait_us(MATRIX_IO_DELAY); }
+uint32_t timer_read32(void) { return 0; }
+uint32_t timer_elapsed32(uint32_t last) { return 0; }
+
+static void expect_rows(const matrix_row_t rows[], const char *what, long scan) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (rows[row] == keys[row]) continue;
+        if (failures++ < 10) printf("scan %ld, %s, row %u: 0x%03X, expected 0x%03X\n", scan, what, row, rows[row], keys[row]);
+    }
+}
+
+int main(void) {
+    srand(1);
+    matrix_init_custom();
+    matrix_row_t by_pin[MATRIX_ROWS] = {0}, by_port[MATRIX_ROWS] = {0};
+    uint32_t pin_us = 0, port_us = 0;
+    for (long scan = 0; scan < TRACE_SCANS; scan++) {
+        // 4回に1回、行ごとにでたらめなキーを押す。その半分はチャタリングで 0 と読める行
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            keys[row] = rand() % 4 == 0 ? rand() & 0x1FF : 0;
+            bounces[row] = rand() % 4 == 0 ? rand() & 0x1FF : 0;
+            if (bounces[row] && rand() % 2) keys[row] = 0;
+        }
+        // スキャンの間はキーボードの他の処理があるので、列は High に戻っている
+        memset(settling, 0, sizeof(settling));
+        uint32_t start = waited_us;
+        scan_by_pin(by_pin);
+        pin_us += waited_us - start;
+        expect_rows(by_pin, "by pin", scan);
+
+        // 変わった行があったときだけ true を返す
+        bool is_changed = memcmp(by_port, keys, sizeof(keys)) != 0;
+        memset(settling, 0, sizeof(settling));
+        start = waited_us;
+        if (matrix_scan_custom(by_port) != is_changed) {
+            if (failures++ < 10) printf("scan %ld: changed is %u\n", scan, !is_changed);
+        }
+        port_us += waited_us - start;
+        expect_rows(by_port, "by port", scan);
+    }
+
+    // 何も押していなければ待たない
+    memset(keys, 0, sizeof(keys));
+    memset(bounces, 0, sizeof(bounces));
+    matrix_row_t idle[MATRIX_ROWS] = {0};
+    uint32_t start = waited_us;
+    if (matrix_scan_custom(idle) || waited_us != start) {
+        failures++;
+        printf("idle scan: waited %u us\n", waited_us - start);
+    }
+
+    printf("matrix: %ld failures (wait per scan: by pin %.1f us, by port %.1f us)\n", failures, (double)pin_us / TRACE_SCANS, (double)port_us / TRACE_SCANS);
+    return failures != 0;
+}
@@ -0,0 +1,133 @@
+// lib_ion/settings.c: EEPROM から読んだ設定の範囲を確かめ、事前に計算する値を計算し直す。範囲外なら全て初期値
+#include "quantum.h"
+#include "lib_ion/rawhid.h"
+#include "lib_ion/settings.h"
+
+joystick_t joystick_state;
+int16_t analogReadPin(pin_t pin) { return 0; }
+void joystick_set_axis(uint8_t axis, int16_t value) {}
+void joystick_flush(void) {}
+void register_joystick_button(uint8_t button) {}
+void unregister_joystick_button(uint8_t button) {}
+report_mouse_t pointing_device_get_report(void) { report_mouse_t report = {0}; return report; }
+void pointing_device_set_report(report_mouse_t report) {}
+void pointing_device_send(void) {}
+uint16_t timer_read(void) { return 0; }
+uint16_t timer_elapsed(uint16_t last) { return 0; }
+
+// EEPROM の代わり
+static uint8_t eeprom[EECONFIG_USER_DATA_SIZE];
+static bool is_eeprom_valid;
+bool eeconfig_is_user_datablock_valid(void) { return is_eeprom_valid; }
+void eeconfig_read_user_datablock(void *data, uint8_t offset, uint8_t size) { memcpy(data, &eeprom[offset], size); }
+void eeconfig_update_user_datablock(const void *data, uint8_t offset, uint8_t size) {
+    memcpy(&eeprom[offset], data, size);
+    is_eeprom_valid = true;
+}
+
+static const struct JOYSTICK_PROFILE PROGMEM default_profiles[] = {
+    JS_PROFILE_DEFAULT,
+    JS_PROFILE(true, JS_CURVE_QUADRATIC, 40, 30, 10),
+};
+
+static long failures = 0;
+
+static void expect(bool ok, const char *what) {
+    if (ok) return;
+    failures++;
+    printf("%s\n", what);
+}
+
+static struct SETTINGS_STATE defaults(void) {
+    struct SETTINGS_STATE state = SETTINGS_INIT(default_profiles);
+    is_eeprom_valid = false;
+    load_settings(&state);
+    return state;
+}
+
+static bool set(struct SETTINGS_STATE *state, uint8_t id, uint8_t index, int16_t value) {
+    uint8_t data[32] = {RAWHID_SETTINGS_SET, id, index, value & 0xFF, (uint16_t)value >> 8};
+    return process_settings_command(state, data);
+}
+
+static void save(struct SETTINGS_STATE *state) {
+    uint8_t data[32] = {RAWHID_SETTINGS_SAVE};
+    process_settings_command(state, data);
+}
+
+// Raw HID で変えて保存した設定
+static struct SETTINGS_STATE changed_settings(void) {
+    struct SETTINGS_STATE state = defaults();
+    expect(set(&state, SETTING_DEADZONE, 1, 120), "set the deadzone");
+    expect(set(&state, SETTING_MOUSE_SPEED, 2, 7), "set the mouse speed");
+    expect(set(&state, SETTING_CALIBRATION, 1, 500), "set the calibration");
+    expect(set(&state, SETTING_OLED_PERIOD, 1, 250), "set the OLED period");
+    save(&state);
+    return state;
+}
+
+// EEPROM の保存された設定を書き換えて読み込む
+static bool load_modified(void (*modify)(struct SETTINGS *saved)) {
+    struct SETTINGS_STATE state = changed_settings();
+    modify((struct SETTINGS *)eeprom);
+    load_settings(&state);
+    struct SETTINGS_STATE initial = defaults();
+    return memcmp(&state.values, &initial.values, sizeof(state.values)) == 0;
+}
+
+static void old_version(struct SETTINGS *saved) { saved->version = SETTINGS_VERSION - 1; }
+static void mouse_byte(struct SETTINGS *saved) { *(uint8_t *)&saved->profiles[3].is_mouse = 2; }
+static void curve(struct SETTINGS *saved) { saved->profiles[0].curve = JS_CURVE_QUADRATIC + 1; }
+static void deadzone(struct SETTINGS *saved) { saved->profiles[1].deadzone = JS_ADC_MAX + 1; }
+static void rapid_interval(struct SETTINGS *saved) { saved->profiles[2].rapid_interval = 0; }
+static void mouse_speed_zero(struct SETTINGS *saved) { saved->profiles[2].mouse_speed = 0; }
+static void mouse_speed_high(struct SETTINGS *saved) { saved->profiles[2].mouse_speed = 128; }
+static void calibration_order(struct SETTINGS *saved) { saved->calibration[0].mid = saved->calibration[0].low; }
+static void calibration_range(struct SETTINGS *saved) { saved->calibration[1].high = JS_ADC_MAX + 1; }
+static void calibration_negative(struct SETTINGS *saved) { saved->calibration[1].low = -1; }
+static void oled_period(struct SETTINGS *saved) { saved->oled_periods[3] = 10001; }
+
+int main(void) {
+    // 保存した値をそのまま読み込む
+    struct SETTINGS_STATE state = changed_settings();
+    struct SETTINGS expected = state.values;
+    state = defaults();
+    is_eeprom_valid = true;
+    load_settings(&state);
+    expect(memcmp(&state.values, &expected, sizeof(expected)) == 0, "the saved settings are loaded");
+
+    // 事前に計算した値は EEPROM のものではなく計算し直す
+    struct SETTINGS *saved = (struct SETTINGS *)eeprom;
+    saved->profiles[1].squared_deadzone = 1;
+    saved->profiles[2].mouse_scale = 1;
+    saved->calibration[0].low_scale = 1;
+    saved->calibration[1].high_range = 1;
+    load_settings(&state);
+    expect(memcmp(&state.values, &expected, sizeof(expected)) == 0, "the precomputed values are computed again");
+
+    // 範囲外の値が1つでもあれば全て初期値
+    static const struct {
+        void (*modify)(struct SETTINGS *saved);
+        const char *name;
+    } invalid[] = {
+        {old_version, "an old version"},
+        {mouse_byte, "a mouse flag of 2"},
+        {curve, "an unknown curve"},
+        {deadzone, "a deadzone above JS_ADC_MAX"},
+        {rapid_interval, "a rapid interval of 0"},
+        {mouse_speed_zero, "a mouse speed of 0"},
+        {mouse_speed_high, "a mouse speed of 128"},
+        {calibration_order, "a center at an end"},
+        {calibration_range, "a calibration above JS_ADC_MAX"},
+        {calibration_negative, "a negative calibration"},
+        {oled_period, "an OLED period above 10000 ms"},
+    };
+    for (uint8_t i = 0; i < ARRAY_SIZE(invalid); i++) {
+        if (load_modified(invalid[i].modify)) continue;
+        failures++;
+        printf("%s is loaded\n", invalid[i].name);
+    }
+
+    printf("settings: %ld failures\n", failures);
+    return failures != 0;
+}
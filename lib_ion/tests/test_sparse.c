@@ -0,0 +1,61 @@
+// lib_ion/keymap_sparse.c: 差分のレイヤーのキーが基準のレイヤーと差分を重ねたものになること、
+// レイヤーを行き来してもキャッシュが正しく入れ替わること、計測の後もキャッシュが使えること
+#include "quantum.h"
+#include "keymap_introspection.h"
+#include "lib_ion/keymap_sparse.h"
+
+#define FULL_LAYERS 2
+#define SPARSE_FIRST FULL_LAYERS
+
+static uint16_t full[FULL_LAYERS][MATRIX_ROWS][MATRIX_COLS];
+static uint16_t now_us;
+static long failures = 0;
+
+uint16_t keycode_at_keymap_location(uint8_t layer, uint8_t row, uint8_t col) {
+    // 表の外のレイヤーは KC_TRNS の代わりに 1
+    return layer < FULL_LAYERS ? full[layer][row][col] : 1;
+}
+uint16_t read_timer_us(void) { return now_us += 3; }
+
+static const struct SPARSE_KEY a_keys[] = {SK(3, 8, 0x1234)};
+static const struct SPARSE_KEY b_keys[] = {SK(0, 0, 7), SK(3, 6, 9), SK(1, 2, 0x7E00)};
+static const struct SPARSE_LAYER layers[] = {SPARSE_LAYER(0, a_keys), SPARSE_LAYER(1, b_keys)};
+
+static uint16_t expected(uint8_t layer, uint8_t row, uint8_t col) {
+    if (layer < FULL_LAYERS) return full[layer][row][col];
+    if (layer >= SPARSE_FIRST + ARRAY_SIZE(layers)) return 1;
+    const struct SPARSE_LAYER *sparse = &layers[layer - SPARSE_FIRST];
+    for (uint8_t i = 0; i < sparse->count; i++) {
+        if (sparse->keys[i].pos == row * MATRIX_COLS + col) return sparse->keys[i].keycode;
+    }
+    return full[sparse->base][row][col];
+}
+
+static void check_all(struct SPARSE_CACHE *cache, uint8_t layer) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint16_t keycode = sparse_keycode(cache, layer, row, col, SPARSE_FIRST, layers, ARRAY_SIZE(layers));
+            if (keycode == expected(layer, row, col)) continue;
+            if (failures++ < 10) printf("layer %u (%u, %u): %04X, expected %04X\n", layer, row, col, keycode, expected(layer, row, col));
+        }
+    }
+}
+
+int main(void) {
+    for (uint8_t layer = 0; layer < FULL_LAYERS; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) full[layer][row][col] = layer * 1000 + row * 10 + col;
+        }
+    }
+    struct SPARSE_CACHE cache = SPARSE_CACHE_INIT;
+    // 全てのレイヤーを2周して、差分のレイヤーの間の切り替えと、通常のレイヤーを挟んだ切り替えを通す
+    static const uint8_t order[] = {2, 3, 2, 0, 3, 3, 1, 2, 4, 2};
+    for (uint8_t i = 0; i < ARRAY_SIZE(order); i++) check_all(&cache, order[i]);
+    // 計測はキャッシュを空にして終わるので、次の検索で展開し直す
+    struct SPARSE_BENCHMARK benchmark;
+    run_sparse_benchmark(&benchmark, &cache, SPARSE_FIRST, layers, ARRAY_SIZE(layers));
+    if (cache.layer != 0xFF) failures++;
+    check_all(&cache, 3);
+    printf("sparse: %ld failures\n", failures);
+    return failures != 0;
+}
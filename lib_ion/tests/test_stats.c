@@ -0,0 +1,70 @@
+// lib_ion/stats.c: 1秒ごとの区間は最初のスキャンから始まり、起動してからの時間や scan_us = 0 からの間隔を数えない
+#include "quantum.h"
+#include "host.h"
+#include "lib_ion/stats.h"
+
+static long failures = 0;
+static uint16_t now;
+static uint16_t now_us;
+static host_driver_t *driver;
+static uint16_t sent_keyboard;
+
+uint16_t timer_read(void) { return now; }
+uint16_t timer_elapsed(uint16_t last) { return now - last; }
+uint16_t read_timer_us(void) { return now_us; }
+host_driver_t *host_get_driver(void) { return driver; }
+void host_set_driver(host_driver_t *new_driver) { driver = new_driver; }
+
+static void send_keyboard(report_keyboard_t *report) { sent_keyboard++; }
+static host_driver_t usb_driver = {NULL, send_keyboard, NULL, NULL};
+
+// 1ms ごとのスキャンを count 回
+static void scan(struct SCAN_STATS *stats, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        now++;
+        now_us += 1000;
+        count_scan(stats);
+    }
+}
+
+static void expect(const char *what, uint16_t value, uint16_t expected) {
+    if (value == expected) return;
+    failures++;
+    printf("%s: %u, expected %u\n", what, value, expected);
+}
+
+int main(void) {
+    struct SCAN_STATS stats = SCAN_STATS_INIT;
+    driver = &usb_driver;
+
+    // 起動してから 5.3秒後に最初のスキャン (us のタイマーは 0 から遠いところ)
+    now = 5300;
+    now_us = 40000;
+    count_scan(&stats);
+    expect("no rate at the first scan", stats.scan_rate, 0);
+    scan(&stats, 999);
+    expect("no rate before a whole second", stats.scan_rate, 0);
+    scan(&stats, 1);
+    expect("scans of the first second", stats.scan_rate, 1000);
+    expect("longest interval of the first second", stats.max_scan_interval, 1000);
+
+    // 次の区間: 1回だけ遅いスキャン、キーボードのレポートはホストのドライバで、ジョイスティックは count_report() で数える
+    scan(&stats, 499);
+    now += 2;
+    now_us += 2500;
+    count_scan(&stats);
+    driver->send_keyboard(NULL);
+    count_report(&stats, REPORT_JOYSTICK);
+    count_report(&stats, REPORT_JOYSTICK);
+    scan(&stats, 498);
+    expect("no rate before the second is over", stats.scan_rate, 1000);
+    scan(&stats, 1);
+    expect("scans of the second with a slow scan", stats.scan_rate, 999);
+    expect("longest interval with a slow scan", stats.max_scan_interval, 2500);
+    expect("keyboard reports", stats.report_rate[REPORT_KEYBOARD], 1);
+    expect("joystick reports", stats.report_rate[REPORT_JOYSTICK], 2);
+    expect("keyboard reports reach the USB driver", sent_keyboard, 1);
+
+    printf("stats: %ld failures\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,69 @@
+// lib_ion/telemetry.c: 送信はバックグラウンドのタスクで行い、送れないうちにできたレポートは捨てても時刻がずれない
+#include "quantum.h"
+#include "lib_ion/joystick.h"
+#include "lib_ion/telemetry.h"
+#include "lib_ion/rawhid.h"
+
+#define TRACE_SAMPLES 3000
+
+static uint16_t now_us;
+static uint8_t sent_report[TELEMETRY_REPORT_SIZE];
+static uint16_t sent;
+static long failures = 0;
+
+uint16_t read_timer_us(void) { return now_us; }
+uint16_t timer_read(void) { return now_us / 1000; }
+uint16_t timer_elapsed(uint16_t last) { return (uint16_t)(now_us / 1000 - last); }
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    memcpy(sent_report, data, length);
+    sent++;
+}
+
+static void expect(bool ok, const char *what, long value) {
+    if (ok) return;
+    if (failures++ < 10) printf("%s: %ld\n", what, value);
+}
+
+int main(void) {
+    static struct TELEMETRY_STATE telemetry = TELEMETRY_INIT;
+    struct JOYSTICK_STATE js_state = JS_INIT;
+    set_telemetry(&telemetry, true);
+    uint32_t host_us = 0;
+    uint8_t next_seq = 0;
+    uint16_t lost = 0, batches = 0;
+    for (uint16_t i = 0; i < TRACE_SAMPLES; i++) {
+        // 1ms ごとのサンプル。ホストは5回に2回しか送る時間をくれない
+        now_us += 1000;
+        js_state.raw.x = i & 0x0FFF;
+        run_telemetry(&telemetry, &js_state);
+        if (telemetry.count == 0) batches++;
+        if (i % 5 >= 2) continue;
+        uint16_t before = sent;
+        send_telemetry(&telemetry);
+        if (sent == before) continue;
+        // ホストと同じく、番号の飛びを数えて間隔を足す
+        expect(sent_report[0] == RAWHID_TELEMETRY_DATA && sent_report[2] == TELEMETRY_SAMPLES, "header", sent_report[0]);
+        lost += (uint8_t)(sent_report[1] - next_seq);
+        next_seq = sent_report[1] + 1;
+        for (uint8_t s = 0; s < TELEMETRY_SAMPLES; s++) {
+            uint8_t *p = &sent_report[TELEMETRY_HEADER_SIZE + s * TELEMETRY_SAMPLE_SIZE];
+            host_us += p[7] | p[8] << 8;
+        }
+        // 最後のサンプルの生の値が、そのときの時刻と合っている
+        uint8_t *last = &sent_report[TELEMETRY_HEADER_SIZE + (TELEMETRY_SAMPLES - 1) * TELEMETRY_SAMPLE_SIZE];
+        uint16_t raw_x = last[0] | (last[1] & 0x0F) << 8;
+        expect(host_us == (uint32_t)(raw_x + 1) * 1000, "time of the sample", raw_x);
+    }
+    expect(lost > 0, "no report was dropped", lost);
+    // 捨てずに溜まっている最後のレポートを除いて、全てのレポートが送られたか捨てられた
+    expect(sent + lost + telemetry.is_queued == batches, "sent, dropped and queued reports", sent + lost + telemetry.is_queued);
+
+    // 何も溜まっていなければ送らない
+    uint16_t before = sent;
+    send_telemetry(&telemetry);
+    send_telemetry(&telemetry);
+    expect(sent - before <= 1, "sent twice", sent - before);
+
+    printf("telemetry: %ld failures (%u sent, %u dropped)\n", failures, sent, lost);
+    return failures != 0;
+}
@@ -0,0 +1,27 @@
+// 短い間隔を測るための us 単位の時刻 (下位16ビットだけ)
+#include QMK_KEYBOARD_H
+#include "lib_ion/ram_func.h"
+#include "lib_ion/timer_us.h"
+#if defined(__AVR__)
+#include "timer_avr.h"
+#else
+// QMK の RP2040 の chconf.h は 1MHz
+_Static_assert(CH_CFG_ST_FREQUENCY == 1000000, "read_timer_us() needs a system timer of 1 MHz");
+#endif
+
+RAM_FUNC uint16_t read_timer_us(void) {
+    #if defined(__AVR__)
+    // QMK の timer0 のカウンタが 1ms の中の位置になる。読む間に 1ms 進んだらやり直す
+    uint8_t raw;
+    uint16_t ms;
+    do {
+        raw = TIMER_RAW;
+        ms = timer_read();
+    } while (TIMER_RAW < raw);
+    // 16MHz では 250 カウントで 1ms (1カウント 4us)
+    return ms * 1000U + raw * (uint16_t)(1000000 / TIMER_RAW_FREQ);
+    #else
+    // TIME_I2US() は64ビットの除算になるので、1カウント 1us のシステムタイマーをそのまま使う
+    return (uint16_t)chVTGetSystemTimeX();
+    #endif
+}
@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+
+// Microsecond time for measuring short intervals (the scan interval, the run time of a task).
+// Only the lower 16 bits are kept, so intervals up to 65 ms can be measured with a subtraction.
+uint16_t read_timer_us(void);
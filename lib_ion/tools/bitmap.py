@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+# Copyright 2025 Neo Trinity
+# SPDX-License-Identifier: GPL-2.0-or-later
+"""Convert a monochrome image into a compressed bitmap for render_bitmap_P() in lib_ion/oled.c.
+
+The image is packed in the order of the OLED buffer: pages of 8 pixel rows,
+each page as one byte per column (LSB is the top row), and compressed with RLE
+when that makes it smaller. PBM (P1/P4) is read as it is; other formats such as PNG need Pillow.
+
+The first byte is the format (BITMAP_RAW / BITMAP_RLE in lib_ion/bitmap.h):
+    BITMAP_RAW: the packed bytes as they are
+    BITMAP_RLE: control bytes n, each followed by
+        n < 0x80: n + 1 literal bytes
+        n >= 0x80: one byte repeated (n - 0x80 + 2) times
+
+usage: bitmap.py --name lhp_logo_bitmap logo.pbm logo_bitmap.h
+"""
+
+import argparse
+import sys
+from pathlib import Path
+
+MAX_LITERAL = 0x80
+MAX_REPEAT = 0x81
+BITMAP_RAW = 0x00
+BITMAP_RLE = 0x01
+
+
+def read_pbm(path):
+    data = path.read_bytes()
+    tokens, pos = [], 0
+    # Header: magic, width, height (with comments)
+    while len(tokens) < 3:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            pos = data.index(b'\n', pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        tokens.append(data[pos:end].decode())
+        pos = end
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+    if magic == 'P1':
+        bits = [int(c) for c in data[pos:].decode() if c in '01']
+        return width, height, [bits[y * width:(y + 1) * width] for y in range(height)]
+    if magic == 'P4':
+        stride = (width + 7) // 8
+        raw = data[pos + 1:]
+        return width, height, [[(raw[y * stride + x // 8] >> (7 - x % 8)) & 1 for x in range(width)] for y in range(height)]
+    sys.exit('{}: unsupported PBM type {}'.format(path, magic))
+
+
+def read_image(path):
+    if path.suffix.lower() == '.pbm':
+        return read_pbm(path)
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit('{}: Pillow is required for non-PBM images'.format(path))
+    image = Image.open(path).convert('1')
+    width, height = image.size
+    # PBM uses 1 for black (lit on the OLED): treat dark pixels as lit in the same way
+    return width, height, [[int(image.getpixel((x, y)) == 0) for x in range(width)] for y in range(height)]
+
+
+def pack(width, height, pixels):
+    packed = []
+    for page in range((height + 7) // 8):
+        for x in range(width):
+            byte = 0
+            for bit in range(8):
+                y = page * 8 + bit
+                if y < height and pixels[y][x]:
+                    byte |= 1 << bit
+            packed.append(byte)
+    return packed
+
+
+def rle(data):
+    out, literal, i = [], [], 0
+
+    def flush():
+        if literal:
+            out.append(len(literal) - 1)
+            out.extend(literal)
+            literal.clear()
+
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < MAX_REPEAT:
+            run += 1
+        if run >= 2:
+            flush()
+            out.extend([0x80 + run - 2, data[i]])
+            i += run
+        else:
+            literal.append(data[i])
+            if len(literal) == MAX_LITERAL:
+                flush()
+            i += 1
+    flush()
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--name', required=True, help='name of the PROGMEM array')
+    parser.add_argument('image', type=Path)
+    parser.add_argument('header', type=Path)
+    args = parser.parse_args()
+
+    width, height, pixels = read_image(args.image)
+    packed = pack(width, height, pixels)
+    compressed = rle(packed)
+    # A dense image does not get smaller with RLE: keep it raw then
+    if len(compressed) < len(packed):
+        data, encoding = [BITMAP_RLE] + compressed, 'RLE'
+    else:
+        data, encoding = [BITMAP_RAW] + packed, 'raw'
+    rows = [', '.join('0x{:02X}'.format(v) for v in data[i:i + 16]) for i in range(0, len(data), 16)]
+    prefix = args.name.upper()
+    args.header.write_text(
+        '// Generated by lib_ion/tools/bitmap.py from {} - do not edit\n'
+        '\n'
+        '#pragma once\n'
+        '\n'
+        '#define {}_WIDTH {}\n'
+        '#define {}_PAGES {}\n'
+        '\n'
+        '// {}x{} px, {} bytes ({}) from {} bytes\n'
+        'static const uint8_t PROGMEM {}[] = {{\n'
+        '    {},\n'
+        '}};\n'.format(args.image.name, prefix, width, prefix, (height + 7) // 8,
+                       width, height, len(data), encoding, len(packed), args.name, ',\n    '.join(rows)))
+    print('{}: {} -> {} bytes ({})'.format(args.header, len(packed), len(data), encoding))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# Copyright 2025 Neo Trinity
+# SPDX-License-Identifier: GPL-2.0-or-later
+"""Generate a subset of a glcdfont file with only the glyphs the firmware prints.
+
+ASCII glyphs keep their codes so that strings in the keymaps work as they are.
+The range before the first and after the last used ASCII character is dropped.
+Logo glyphs (0x80 and above) are renumbered to follow the last ASCII glyph.
+The renumbered logo is written to the header as LHP_LOGO_SUBSET.
+Without --logo (e.g. the logo is drawn as a bitmap) the logo glyphs are dropped.
+
+usage: font_subset.py --font glcdfont.c [--logo board.h] \\
+           --out-font glcdfont_subset.c --out-header font_subset.h SOURCE_DIR_OR_FILE...
+"""
+
+import argparse
+import codecs
+import re
+import sys
+from pathlib import Path
+
+FONT_WIDTH = 6
+
+COMMENT_RE = re.compile(r'//[^\n]*|/\*.*?\*/', re.S)
+STRING_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+CHAR_RE = re.compile(r"'((?:[^'\\\n]|\\.)+)'")
+HEX_RE = re.compile(r'0x[0-9A-Fa-f]{2}\b')
+FONT_RE = re.compile(r'font\[\][^=]*=\s*\{(.*?)\};', re.S)
+LOGO_RE = re.compile(r'lhp_logo(\[[^=]*\])\s*=\s*(\{.*?\});', re.S)
+
+
+def decode(literal):
+    return codecs.decode(literal, 'unicode_escape')
+
+
+def used_characters(paths):
+    """Collects characters of all string and char literals in the C sources."""
+    chars = set('0123456789')
+    for path in paths:
+        files = sorted(path.rglob('*.[ch]')) if path.is_dir() else [path]
+        for f in files:
+            text = COMMENT_RE.sub('', f.read_text(encoding='utf-8', errors='replace'))
+            for literal in STRING_RE.findall(text) + CHAR_RE.findall(text):
+                chars.update(decode(literal))
+    return {ord(c) for c in chars if 0x20 <= ord(c) < 0x80}
+
+
+def read_font(path):
+    body = FONT_RE.search(COMMENT_RE.sub('', path.read_text(encoding='utf-8'))).group(1)
+    data = [int(v, 16) for v in re.findall(r'0x[0-9A-Fa-f]+', body)]
+    return [data[i:i + FONT_WIDTH] for i in range(0, len(data), FONT_WIDTH)]
+
+
+def format_glyph(glyph, code, comment):
+    values = ', '.join('0x{:02X}'.format(v) for v in glyph)
+    return '    {},  // 0x{:02X}: {}'.format(values, code, comment)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--font', type=Path, required=True)
+    parser.add_argument('--logo', type=Path)
+    parser.add_argument('--out-font', type=Path, required=True)
+    parser.add_argument('--out-header', type=Path, required=True)
+    parser.add_argument('--extra', default='', help='characters to keep in addition to the scanned ones')
+    parser.add_argument('sources', type=Path, nargs='+')
+    args = parser.parse_args()
+
+    glyphs = read_font(args.font)
+    ascii_codes = used_characters(args.sources) | {ord(c) for c in args.extra}
+    logo_dims, logo_body, logo_codes = None, None, []
+    if args.logo:
+        logo_match = LOGO_RE.search(args.logo.read_text(encoding='utf-8'))
+        if logo_match is None:
+            sys.exit('{}: lhp_logo is not found'.format(args.logo))
+        logo_dims, logo_body = logo_match.groups()
+        logo_codes = sorted({int(v, 16) for v in HEX_RE.findall(logo_body)} - {0})
+    ascii_codes |= {c for c in logo_codes if c < 0x80}
+    logo_codes = [c for c in logo_codes if c >= 0x80]
+
+    start, ascii_end = min(ascii_codes), max(ascii_codes)
+    remap = {c: ascii_end + 1 + i for i, c in enumerate(logo_codes)}
+    end = ascii_end + len(logo_codes)
+    if end > 0xFF or max(logo_codes, default=0) >= len(glyphs):
+        sys.exit('{}: the glyphs do not fit'.format(args.font))
+
+    lines = [format_glyph(glyphs[c], c, repr(chr(c))) for c in range(start, ascii_end + 1)]
+    lines += [format_glyph(glyphs[c], remap[c], 'logo 0x{:02X}'.format(c)) for c in logo_codes]
+    args.out_font.write_text(
+        '// Generated by lib_ion/tools/font_subset.py from {} - do not edit\n'
+        '\n'
+        '#include "progmem.h"\n'
+        '\n'
+        '// {} of {} glyphs, {} bytes\n'
+        'static const unsigned char PROGMEM font[] = {{\n'
+        '{}\n'
+        '}};\n'.format(args.font.name, end - start + 1, len(glyphs), (end - start + 1) * FONT_WIDTH, '\n'.join(lines)))
+
+    header = (
+        '// Generated by lib_ion/tools/font_subset.py from {} - do not edit\n'
+        '\n'
+        '#pragma once\n'
+        '\n'
+        '#define OLED_FONT_START 0x{:02X}\n'
+        '#define OLED_FONT_END 0x{:02X}\n'.format(args.font.name, start, end))
+    if logo_body is not None:
+        logo = HEX_RE.sub(lambda m: '0x{:02X}'.format(remap.get(int(m.group(0), 16), int(m.group(0), 16))), logo_body)
+        logo = ' \\\n'.join(logo.splitlines())
+        header += (
+            '\n'
+            '// lhp_logo{} with the glyphs renumbered for the subset font\n'
+            '#define LHP_LOGO_SUBSET {}\n'.format(logo_dims, logo))
+    args.out_header.write_text(header)
+
+    print('{}: {} -> {} bytes'.format(args.out_font, len(glyphs) * FONT_WIDTH, (end - start + 1) * FONT_WIDTH))
+
+
+if __name__ == '__main__':
+    main()
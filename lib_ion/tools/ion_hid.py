@@ -0,0 +1,442 @@
+#!/usr/bin/env python3
+# Copyright 2025 Neo Trinity
+# SPDX-License-Identifier: GPL-2.0-or-later
+"""Talk to a keyboard built with RAW_ENABLE = yes over the lib_ion raw HID protocol (lib_ion/rawhid.h).
+
+Linux only: the device is opened as /dev/hidrawN, no extra modules are needed.
+Without --device the first hidraw device with the QMK raw HID usage page is used.
+
+commands:
+    version     print the protocol version of the firmware
+    stats       print the scan rate, the longest scan, the HID reports per second of each endpoint,
+                the press latency histogram and the recent key events
+    stream      stream the stick telemetry as CSV (time_us, raw_x, raw_y, x, y, dt_us);
+                --plot shows it live (needs matplotlib)
+    tasks       print the period, budget, deadline misses, budget overruns and longest run
+                of each task of the scheduler (lib_ion/scheduler.h); the budget is "-" while it is
+                not measured (TASK_BUDGET_UNMEASURED): set it from the longest run
+    settings    print all the runtime settings (lib_ion/settings.h)
+    get NAME [INDEX]        print one setting (INDEX: layer, OLED page; default 0)
+    set NAME [INDEX] VALUE  change a setting until the keyboard is reset (the stick mode of the layer is reset too)
+    save        save the settings to the EEPROM
+    reset       go back to the default settings (save to clear the EEPROM too)
+
+setting names: mouse, curve, deadzone, rapid_interval, mouse_speed (index: layer),
+               x_low, x_mid, x_high, y_low, y_mid, y_high (raw ADC), oled_period (index: OLED page, ms)
+
+--mock talks to a simulated keyboard instead of a device, to try the tool and the protocol without one.
+
+usage: ion_hid.py [--device /dev/hidraw3] stats
+       ion_hid.py stream --seconds 10 --csv stick.csv --plot
+       ion_hid.py set deadzone 3 120 && ion_hid.py save
+"""
+
+import argparse
+import glob
+import math
+import os
+import select
+import struct
+import sys
+import time
+
+REPORT_SIZE = 32
+RAW_USAGE_PAGE = 0xFF60
+PROTOCOL_VERSION = 7
+
+GET_VERSION = 0x01
+GET_STATS = 0x02
+TELEMETRY = 0x03
+TELEMETRY_DATA = 0x04
+SETTINGS_GET = 0x05
+SETTINGS_SET = 0x06
+SETTINGS_SAVE = 0x07
+SETTINGS_RESET = 0x08
+GET_TASK = 0x09
+ERROR = 0xFF
+
+# lib_ion/stats.h
+LATENCY_BIN_US = 125
+KEY_EVENT_DUMP_SIZE = 5
+KEY_EVENT_DUMP_PER_PAGE = 6
+REPORT_ENDPOINTS = ['keyboard', 'mouse', 'joystick']
+
+# lib_ion/telemetry.h
+TELEMETRY_HEADER_SIZE = 3
+TELEMETRY_SAMPLE_SIZE = 9
+TELEMETRY_SAMPLES = (REPORT_SIZE - TELEMETRY_HEADER_SIZE) // TELEMETRY_SAMPLE_SIZE
+TELEMETRY_TIMEOUT = 2.0
+
+# lib_ion/scheduler.h
+TASK_BUDGET_UNMEASURED = 0xFFFF
+
+# lib_ion/settings.h: name -> (SETTING_ID, index offset, indexed)
+SETTINGS = {
+    'mouse': (0x01, 0, True),
+    'curve': (0x02, 0, True),
+    'deadzone': (0x03, 0, True),
+    'rapid_interval': (0x04, 0, True),
+    'mouse_speed': (0x05, 0, True),
+    'x_low': (0x10, 0, False),
+    'x_mid': (0x10, 1, False),
+    'x_high': (0x10, 2, False),
+    'y_low': (0x10, 3, False),
+    'y_mid': (0x10, 4, False),
+    'y_high': (0x10, 5, False),
+    'oled_period': (0x20, 0, True),
+}
+
+
+def find_device():
+    """Returns the first hidraw node whose report descriptor has the raw HID usage page."""
+    usage_page = bytes([0x06]) + struct.pack('<H', RAW_USAGE_PAGE)
+    for path in sorted(glob.glob('/sys/class/hidraw/hidraw*')):
+        try:
+            with open(os.path.join(path, 'device', 'report_descriptor'), 'rb') as f:
+                if usage_page in f.read():
+                    return '/dev/' + os.path.basename(path)
+        except OSError:
+            continue
+    sys.exit('no raw HID device is found (is RAW_ENABLE = yes in the firmware?)')
+
+
+class Device:
+    def __init__(self, path, timeout=1.0):
+        self.fd = os.open(path, os.O_RDWR)
+        self.timeout = timeout
+
+    def close(self):
+        os.close(self.fd)
+
+    def send(self, command, *args):
+        report = bytes([command, *args]).ljust(REPORT_SIZE, b'\0')
+        # hidraw needs the report ID (0: none) in front
+        os.write(self.fd, b'\0' + report)
+
+    def read_report(self, timeout):
+        """Returns the next report from the keyboard, None on timeout."""
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        if not ready:
+            return None
+        return os.read(self.fd, REPORT_SIZE + 1)[-REPORT_SIZE:]
+
+    def transfer(self, command, *args, check=True):
+        """Sends a command and returns the payload of the reply (data[1:]), skipping the telemetry reports.
+
+        With check=False an error reply returns None instead of exiting.
+        """
+        self.send(command, *args)
+        while True:
+            reply = self.read_report(self.timeout)
+            if reply is None:
+                sys.exit('no reply to command 0x{:02X}'.format(command))
+            if reply[0] == ERROR:
+                if not check:
+                    return None
+                sys.exit('command 0x{:02X} is not supported by the firmware'.format(command))
+            if reply[0] == command:
+                return reply[1:]
+
+
+class MockDevice:
+    """Simulated keyboard: answers the commands like the firmware and streams a stick moving in a circle.
+
+    The reports are packed here independently of the decoder, in the same layout as lib_ion/telemetry.c.
+    """
+
+    SCAN_US = 1200
+    PROFILE_COUNT = 4
+    OLED_PAGE_COUNT = 4
+    DEFAULTS = {0x01: [0] * PROFILE_COUNT, 0x02: [0] * PROFILE_COUNT, 0x03: [64] * PROFILE_COUNT,
+                0x04: [60] * PROFILE_COUNT, 0x05: [20] * PROFILE_COUNT,
+                0x10: [784, 444, 172, 244, 532, 822], 0x20: [0, 500, 50, 100]}
+    LIMITS = {0x01: (0, 1), 0x02: (0, 2), 0x03: (0, 1023), 0x04: (1, 10000), 0x05: (1, 127), 0x10: (0, 1023), 0x20: (0, 10000)}
+
+    # period, budget, misses, overruns, max_time (the tasks of lhp14lite_d/keymaps/mymap, budgets not measured)
+    TASKS = [(0, TASK_BUDGET_UNMEASURED, 0, 0, 8), (1, TASK_BUDGET_UNMEASURED, 0, 0, 212), (1, TASK_BUDGET_UNMEASURED, 2, 0, 148),
+             (1, TASK_BUDGET_UNMEASURED, 0, 0, 12), (0, TASK_BUDGET_UNMEASURED, 0, 0, 30), (0, TASK_BUDGET_UNMEASURED, 0, 0, 410),
+             (0, TASK_BUDGET_UNMEASURED, 0, 0, 96)]
+
+    def __init__(self):
+        self.settings = {id: list(values) for id, values in self.DEFAULTS.items()}
+        self.active = False
+        self.keepalive = 0.0
+        self.seq = 0
+        self.scan = 0
+        self.pending = []
+
+    def close(self):
+        pass
+
+    def send(self, command, *args):
+        args = list(args) + [0] * (REPORT_SIZE - 1 - len(args))
+        reply = bytearray([command] + args)
+        if command == GET_VERSION:
+            reply[1] = PROTOCOL_VERSION
+        elif command == GET_STATS:
+            if args[0] == 0:
+                struct.pack_into('<HBBB8HB3HH', reply, 2, 1000, 8, 8, 0, 0, 3, 5, 1, 0, 0, 0, 0, 3, 0, 0, 1000, 1450)
+        elif command == TELEMETRY:
+            self.active = args[0] != 0
+            self.keepalive = time.monotonic()
+        elif command in (SETTINGS_GET, SETTINGS_SET) and args[1] < len(self.settings.get(args[0], [])):
+            values, (low, high) = self.settings[args[0]], self.LIMITS[args[0]]
+            value = struct.unpack_from('<h', reply, 3)[0]
+            if command == SETTINGS_GET:
+                struct.pack_into('<h', reply, 3, values[args[1]])
+            elif low <= value <= high:
+                values[args[1]] = value
+            else:
+                reply[0] = ERROR
+        elif command == SETTINGS_SAVE:
+            reply[1] = 1
+        elif command == SETTINGS_RESET:
+            self.settings = {id: list(values) for id, values in self.DEFAULTS.items()}
+        elif command == GET_TASK:
+            tasks = self.TASKS
+            struct.pack_into('<B5H', reply, 2, len(tasks), *(tasks[args[0]] if args[0] < len(tasks) else (0,) * 5))
+        else:
+            reply[0] = ERROR
+        self.pending.append(bytes(reply))
+
+    def sample(self):
+        angle = self.scan * 2 * math.pi * self.SCAN_US / 1e6
+        x, y = round(127 * math.cos(angle)), round(127 * math.sin(angle))
+        raw_x, raw_y = 444 + x * 340 // 127, 532 + y * 290 // 127
+        self.scan += 1
+        return bytes([raw_x & 0xFF, (raw_x >> 8) | (raw_y & 0x0F) << 4, raw_y >> 4]) + struct.pack('<hhH', x, y, self.SCAN_US)
+
+    def read_report(self, timeout):
+        if self.pending:
+            return self.pending.pop(0)
+        if not self.active or time.monotonic() - self.keepalive > TELEMETRY_TIMEOUT:
+            self.active = False
+            time.sleep(timeout)
+            return None
+        time.sleep(TELEMETRY_SAMPLES * self.SCAN_US / 1e6)
+        report = bytes([TELEMETRY_DATA, self.seq, TELEMETRY_SAMPLES])
+        report += b''.join(self.sample() for _ in range(TELEMETRY_SAMPLES))
+        self.seq = (self.seq + 1) & 0xFF
+        return report.ljust(REPORT_SIZE, b'\0')
+
+    timeout = 1.0
+    transfer = Device.transfer
+
+
+def get_version(device):
+    return device.transfer(GET_VERSION)[0]
+
+
+def get_stats(device):
+    payload = device.transfer(GET_STATS, 0)[1:]
+    scan_rate, bins, log_size, count = struct.unpack_from('<HBBB', payload)
+    latency = list(struct.unpack_from('<{}H'.format(bins), payload, 5))
+    endpoints = payload[5 + bins * 2]
+    report_rates = list(struct.unpack_from('<{}H'.format(endpoints), payload, 6 + bins * 2))
+    max_scan_interval = struct.unpack_from('<H', payload, 6 + bins * 2 + endpoints * 2)[0]
+    events = []
+    page = 1
+    while len(events) < count:
+        payload = device.transfer(GET_STATS, page)[1:]
+        for i in range(min(KEY_EVENT_DUMP_PER_PAGE, count - len(events))):
+            events.append(struct.unpack_from('<HBBB', payload, i * KEY_EVENT_DUMP_SIZE))
+        page += 1
+    return {'scan_rate': scan_rate, 'max_scan_interval': max_scan_interval, 'report_rates': report_rates, 'latency': latency, 'log_size': log_size, 'events': events}
+
+
+def print_tasks(device):
+    print('task  period   budget  misses  overruns  longest')
+    index, count = 0, 1
+    while index < count:
+        count, period, budget, misses, overruns, max_time = struct.unpack_from('<B5H', device.transfer(GET_TASK, index)[1:])
+        if index < count:
+            print('{:>4}  {:>6}  {:>7}  {:>6}  {:>8}  {:>7}'.format(
+                index, '{} ms'.format(period) if period else 'always',
+                '-' if budget == TASK_BUDGET_UNMEASURED else '{} us'.format(budget), misses, overruns, '{} us'.format(max_time)))
+        index += 1
+
+
+def print_stats(stats):
+    print('scan rate: {}/s'.format(stats['scan_rate']))
+    print('longest scan: {} us'.format(stats['max_scan_interval']))
+    for i, rate in enumerate(stats['report_rates']):
+        name = REPORT_ENDPOINTS[i] if i < len(REPORT_ENDPOINTS) else 'endpoint {}'.format(i)
+        print('{} reports: {}/s'.format(name, rate))
+    latency = stats['latency']
+    total = sum(latency)
+    print('press latency ({} presses):'.format(total))
+    for i, n in enumerate(latency):
+        label = '{}{} us'.format(i * LATENCY_BIN_US, '+' if i == len(latency) - 1 else ' ')
+        bar = '#' * (n * 40 // max(latency)) if n else ''
+        print('  {:>7} {:>6} {}'.format(label, n, bar))
+    print('key events (oldest first, last {}):'.format(stats['log_size']))
+    previous = None
+    for at, row, col, pressed in stats['events']:
+        delta = '' if previous is None else '+{} ms'.format((at - previous) & 0xFFFF)
+        print('  {:>5} ms  row {} col {} {:<8} {}'.format(at, row, col, 'pressed' if pressed else 'released', delta))
+        previous = at
+
+
+def setting_address(name, index):
+    if name not in SETTINGS:
+        sys.exit('unknown setting {} (one of {})'.format(name, ', '.join(SETTINGS)))
+    id, offset, indexed = SETTINGS[name]
+    if index and not indexed:
+        sys.exit('{} has no index'.format(name))
+    return id, offset + index
+
+
+def get_setting(device, name, index=0):
+    """Returns the value, None if the index is out of range."""
+    payload = device.transfer(SETTINGS_GET, *setting_address(name, index), check=False)
+    return None if payload is None else struct.unpack_from('<h', payload, 2)[0]
+
+
+def set_setting(device, name, index, value):
+    id, index = setting_address(name, index)
+    if device.transfer(SETTINGS_SET, id, index, *struct.pack('<h', value), check=False) is None:
+        sys.exit('{} = {} is out of range or not supported by the firmware'.format(name, value))
+
+
+def print_settings(device):
+    for name, (id, offset, indexed) in SETTINGS.items():
+        if not indexed:
+            print('{:<15} {}'.format(name, get_setting(device, name)))
+            continue
+        values = []
+        while True:
+            value = get_setting(device, name, len(values))
+            if value is None:
+                break
+            values.append(value)
+        print('{:<15} {}'.format(name, ' '.join(str(v) for v in values)))
+
+
+def decode_telemetry(report):
+    """Returns (seq, [(raw_x, raw_y, x, y, dt_us), ...]) of a TELEMETRY_DATA report."""
+    seq, count = report[1], report[2]
+    samples = []
+    for i in range(count):
+        offset = TELEMETRY_HEADER_SIZE + i * TELEMETRY_SAMPLE_SIZE
+        p = report[offset:offset + TELEMETRY_SAMPLE_SIZE]
+        raw_x = p[0] | (p[1] & 0x0F) << 8
+        raw_y = p[1] >> 4 | p[2] << 4
+        x, y, dt = struct.unpack_from('<hhH', p, 3)
+        samples.append((raw_x, raw_y, x, y, dt))
+    return seq, samples
+
+
+def stream_telemetry(device, seconds):
+    """Yields (time_us, raw_x, raw_y, x, y, dt_us) and keeps the stream alive until the time is up."""
+    device.send(TELEMETRY, 1)
+    start = keepalive = time.monotonic()
+    time_us, last_seq, lost = 0, None, 0
+    try:
+        while seconds is None or time.monotonic() - start < seconds:
+            if time.monotonic() - keepalive > TELEMETRY_TIMEOUT / 4:
+                device.send(TELEMETRY, 1)
+                keepalive = time.monotonic()
+            report = device.read_report(0.1)
+            if report is None or report[0] != TELEMETRY_DATA:
+                continue
+            seq, samples = decode_telemetry(report)
+            if last_seq is not None and seq != (last_seq + 1) & 0xFF:
+                lost += (seq - last_seq - 1) & 0xFF
+            last_seq = seq
+            for raw_x, raw_y, x, y, dt in samples:
+                time_us += dt
+                yield time_us, raw_x, raw_y, x, y, dt
+    finally:
+        device.send(TELEMETRY, 0)
+        if lost:
+            print('{} reports were lost'.format(lost), file=sys.stderr)
+
+
+class LivePlot:
+    """Raw ADC and output of the last few seconds, redrawn a few times a second."""
+
+    def __init__(self, window):
+        try:
+            import matplotlib.pyplot as plt
+        except ImportError:
+            sys.exit('matplotlib is required for --plot')
+        self.plt = plt
+        self.window = window
+        self.rows = []
+        self.drawn = 0.0
+        plt.ion()
+        self.figure, (self.raw_axes, self.out_axes) = plt.subplots(2, 1, sharex=True)
+        self.raw_lines = [self.raw_axes.plot([], [], label=label)[0] for label in ('raw_x', 'raw_y')]
+        self.out_lines = [self.out_axes.plot([], [], label=label)[0] for label in ('x', 'y')]
+        self.raw_axes.legend(loc='upper left')
+        self.out_axes.legend(loc='upper left')
+        self.out_axes.set_xlabel('s')
+
+    def add(self, row):
+        self.rows.append(row)
+        if time.monotonic() - self.drawn < 0.1:
+            return
+        self.drawn = time.monotonic()
+        end = self.rows[-1][0]
+        self.rows = [r for r in self.rows if end - r[0] <= self.window * 1e6]
+        t = [r[0] / 1e6 for r in self.rows]
+        for i, line in enumerate(self.raw_lines + self.out_lines):
+            line.set_data(t, [r[i + 1] for r in self.rows])
+        for axes in (self.raw_axes, self.out_axes):
+            axes.relim()
+            axes.autoscale_view()
+        self.plt.pause(0.001)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--device', help='hidraw node (default: search by the usage page)')
+    parser.add_argument('--mock', action='store_true', help='use a simulated keyboard')
+    parser.add_argument('--seconds', type=float, help='stream: time to record (default: until Ctrl-C)')
+    parser.add_argument('--csv', type=argparse.FileType('w'), default=sys.stdout, help='stream: output file (default: stdout)')
+    parser.add_argument('--plot', action='store_true', help='stream: plot the last few seconds live')
+    parser.add_argument('command', choices=['version', 'stats', 'stream', 'tasks', 'settings', 'get', 'set', 'save', 'reset'])
+    parser.add_argument('arguments', nargs='*', help='get/set: NAME [INDEX] [VALUE]')
+    args = parser.parse_args()
+
+    device = MockDevice() if args.mock else Device(args.device or find_device())
+    try:
+        if args.command == 'version':
+            version = get_version(device)
+            print('protocol version {}{}'.format(version, '' if version == PROTOCOL_VERSION else ' (this tool: {})'.format(PROTOCOL_VERSION)))
+        elif args.command == 'stats':
+            print_stats(get_stats(device))
+        elif args.command == 'stream':
+            plot = LivePlot(5) if args.plot else None
+            args.csv.write('time_us,raw_x,raw_y,x,y,dt_us\n')
+            for row in stream_telemetry(device, args.seconds):
+                args.csv.write(','.join(str(v) for v in row) + '\n')
+                if plot:
+                    plot.add(row)
+        elif args.command == 'tasks':
+            print_tasks(device)
+        elif args.command == 'settings':
+            print_settings(device)
+        elif args.command in ('get', 'set'):
+            count = len(args.arguments) - (args.command == 'set')
+            if count not in (1, 2):
+                parser.error('{}: NAME [INDEX]{}'.format(args.command, ' VALUE' if args.command == 'set' else ''))
+            name, index = args.arguments[0], int(args.arguments[1]) if count == 2 else 0
+            if args.command == 'set':
+                set_setting(device, name, index, int(args.arguments[-1]))
+            value = get_setting(device, name, index)
+            if value is None:
+                sys.exit('{} has no index {}'.format(name, index))
+            print(value)
+        elif args.command == 'save':
+            print('saved' if device.transfer(SETTINGS_SAVE)[0] else 'the firmware has no EEPROM block for the settings (EECONFIG_USER_DATA_SIZE)')
+        elif args.command == 'reset':
+            device.transfer(SETTINGS_RESET)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        device.close()
+
+
+if __name__ == '__main__':
+    main()